@@ -0,0 +1,92 @@
+#include "AsyncAI.h"
+
+AsyncAI::AsyncAI()
+    : ai(nullptr), pending(false), running(false), ready(false), quit(false), result(-1), busy(false)
+{
+    worker = std::thread(&AsyncAI::Run, this);
+}
+
+AsyncAI::~AsyncAI()
+{
+    Cancel();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void AsyncAI::Start(const MoveProvider& moves, const DynamicBoard& position, const WinTracker& positionTracker)
+{
+    Cancel();
+    const SearchMoves* search = std::get_if<SearchMoves>(&moves);
+    if (search != nullptr)
+        search->ai->ClearStop();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        provider = moves;
+        ai = (search != nullptr) ? search->ai : nullptr;
+        board = position;
+        tracker = positionTracker;
+        pending = true;
+        ready = false;
+    }
+    busy = true;
+    started = std::chrono::steady_clock::now();
+    wake.notify_one();
+}
+
+bool AsyncAI::Poll(int& move)
+{
+    if (!busy)
+        return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready)
+        return false;
+    move = result;
+    ready = false;
+    busy = false;
+    return true;
+}
+
+void AsyncAI::Cancel()
+{
+    if (!busy)
+        return;
+    std::unique_lock<std::mutex> lock(mutex);
+    pending = false;
+    if (running && ai != nullptr)
+        ai->RequestStop();
+    idle.wait(lock, [this] { return !running; });
+    ready = false;
+    busy = false;
+}
+
+double AsyncAI::ThinkingSeconds() const
+{
+    if (!busy)
+        return 0.0;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+void AsyncAI::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        wake.wait(lock, [this] { return pending || quit; });
+        if (quit)
+            return;
+        pending = false;
+        running = true;
+        // the copies are only touched by Start, which cancels this job first
+        lock.unlock();
+        int move = std::visit([this](auto& moves) { return moves.NextMove(board, tracker); }, provider);
+        lock.lock();
+        running = false;
+        result = move;
+        ready = true;
+        idle.notify_all();
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "GenericBoard.h"
+#include "Player.h"
+#include "Strategy.h"
+#include "WinTracker.h"
+
+// Runs a move provider (see Strategy.h) on a worker thread so the render loop keeps its
+// frame rate however long the AI thinks. The main loop starts a move, polls it once per
+// frame and can cancel it; the worker searches its own copy of the position.
+class AsyncAI
+{
+public:
+    AsyncAI();
+    ~AsyncAI();
+    AsyncAI(const AsyncAI&) = delete;
+    AsyncAI& operator=(const AsyncAI&) = delete;
+
+    // what the provider points to must stay alive until the move has been polled or cancelled
+    void Start(const MoveProvider& provider, const DynamicBoard& board, const WinTracker& tracker);
+    // true while a move is being computed or waits to be polled
+    bool IsThinking() const { return busy; }
+    // true once when the move is ready, move is -1 if the game was already over
+    bool Poll(int& move);
+    // stops the search and waits until the worker no longer uses the provider
+    void Cancel();
+    // since Start, 0 when idle
+    double ThinkingSeconds() const;
+
+private:
+    void Run();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::thread worker;
+    MoveProvider provider;
+    AIPlayer* ai;  // the searching player of a SearchMoves provider, asked to stop on Cancel
+    DynamicBoard board;
+    WinTracker tracker;
+    bool pending;  // a job waits for the worker
+    bool running;  // the worker is inside NextMove
+    bool ready;  // result holds a move nobody polled yet
+    bool quit;
+    int result;
+    bool busy;  // main thread view: Start called, not yet polled or cancelled
+    std::chrono::steady_clock::time_point started;
+};
@@ -0,0 +1,162 @@
+#include "BatchWinner.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define BATCH_WINNER_X86 1
+#endif
+// AVX2 is compiled per function so the rest of the build keeps its baseline flags
+#if defined(BATCH_WINNER_X86) && defined(__GNUC__)
+#define BATCH_WINNER_AVX2 1
+#endif
+
+void BatchWinnersScalar(const uint16_t* x, const uint16_t* o, uint8_t* results, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        results[i] = uint8_t(Board::FromMasks(x[i], o[i]).Winner());
+}
+
+#ifdef BATCH_WINNER_X86
+namespace
+{
+static_assert(sizeof(Board::WinMasks) / sizeof(Board::WinMasks[0]) == 8, "the row sets below expect eight win rows");
+
+// The eight row masks as named members, not an array: at -O2 GCC kept a loop over an
+// array rolled and sent every compare through the stack. Written out, the compares stay
+// in registers; masks that don't fit are folded into the ANDs as loads, nothing is stored.
+struct Rows128
+{
+    __m128i r0, r1, r2, r3, r4, r5, r6, r7;
+};
+
+// all ones in the lanes where pieces cover row: no cell of row outside pieces, which
+// needs the row constant once instead of as both AND and compare operand
+inline __m128i Covers128(__m128i pieces, __m128i row)
+{
+    return _mm_cmpeq_epi16(_mm_andnot_si128(pieces, row), _mm_setzero_si128());
+}
+
+// lanes are all ones where the side's mask holds a win row; the eight tests are
+// OR-ed as a tree so they don't wait on each other
+inline __m128i HasLine128(__m128i pieces, const Rows128& rows)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_or_si128(Covers128(pieces, rows.r0), Covers128(pieces, rows.r1)),
+                                     _mm_or_si128(Covers128(pieces, rows.r2), Covers128(pieces, rows.r3))),
+                        _mm_or_si128(_mm_or_si128(Covers128(pieces, rows.r4), Covers128(pieces, rows.r5)),
+                                     _mm_or_si128(Covers128(pieces, rows.r6), Covers128(pieces, rows.r7))));
+}
+
+// checked in the same order as Board::Winner: X, O, full board, otherwise still playing
+inline __m128i Winners128(__m128i x, __m128i o, const Rows128& rows)
+{
+    const __m128i full = _mm_cmpeq_epi16(_mm_or_si128(x, o), _mm_set1_epi16(Board::FullMask));
+    const __m128i winO = HasLine128(o, rows);
+    const __m128i winX = HasLine128(x, rows);
+    __m128i result = _mm_set1_epi16(NO_ONE);
+    result = _mm_or_si128(_mm_andnot_si128(full, result), _mm_and_si128(full, _mm_set1_epi16(TIES)));
+    result = _mm_or_si128(_mm_andnot_si128(winO, result), _mm_and_si128(winO, _mm_set1_epi16(O)));
+    result = _mm_or_si128(_mm_andnot_si128(winX, result), _mm_and_si128(winX, _mm_set1_epi16(X)));
+    return result;
+}
+
+size_t BatchWinnersSse2(const uint16_t* x, const uint16_t* o, uint8_t* results, size_t count)
+{
+    const Rows128 rows = {_mm_set1_epi16(short(Board::WinMasks[0])), _mm_set1_epi16(short(Board::WinMasks[1])),
+                          _mm_set1_epi16(short(Board::WinMasks[2])), _mm_set1_epi16(short(Board::WinMasks[3])),
+                          _mm_set1_epi16(short(Board::WinMasks[4])), _mm_set1_epi16(short(Board::WinMasks[5])),
+                          _mm_set1_epi16(short(Board::WinMasks[6])), _mm_set1_epi16(short(Board::WinMasks[7]))};
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i low = Winners128(_mm_loadu_si128((const __m128i*)(x + i)), _mm_loadu_si128((const __m128i*)(o + i)), rows);
+        const __m128i high = Winners128(_mm_loadu_si128((const __m128i*)(x + i + 8)), _mm_loadu_si128((const __m128i*)(o + i + 8)), rows);
+        _mm_storeu_si128((__m128i*)(results + i), _mm_packus_epi16(low, high));
+    }
+    return i;
+}
+
+#ifdef BATCH_WINNER_AVX2
+struct Rows256
+{
+    __m256i r0, r1, r2, r3, r4, r5, r6, r7;
+};
+
+__attribute__((target("avx2"))) inline __m256i Covers256(__m256i pieces, __m256i row)
+{
+    return _mm256_cmpeq_epi16(_mm256_andnot_si256(pieces, row), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) inline __m256i HasLine256(__m256i pieces, const Rows256& rows)
+{
+    return _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(Covers256(pieces, rows.r0), Covers256(pieces, rows.r1)),
+                                           _mm256_or_si256(Covers256(pieces, rows.r2), Covers256(pieces, rows.r3))),
+                           _mm256_or_si256(_mm256_or_si256(Covers256(pieces, rows.r4), Covers256(pieces, rows.r5)),
+                                           _mm256_or_si256(Covers256(pieces, rows.r6), Covers256(pieces, rows.r7))));
+}
+
+__attribute__((target("avx2"))) size_t BatchWinnersAvx2(const uint16_t* x, const uint16_t* o, uint8_t* results, size_t count)
+{
+    const Rows256 rows = {_mm256_set1_epi16(short(Board::WinMasks[0])), _mm256_set1_epi16(short(Board::WinMasks[1])),
+                          _mm256_set1_epi16(short(Board::WinMasks[2])), _mm256_set1_epi16(short(Board::WinMasks[3])),
+                          _mm256_set1_epi16(short(Board::WinMasks[4])), _mm256_set1_epi16(short(Board::WinMasks[5])),
+                          _mm256_set1_epi16(short(Board::WinMasks[6])), _mm256_set1_epi16(short(Board::WinMasks[7]))};
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i xs = _mm256_loadu_si256((const __m256i*)(x + i));
+        const __m256i os = _mm256_loadu_si256((const __m256i*)(o + i));
+        const __m256i winX = HasLine256(xs, rows);
+        const __m256i winO = HasLine256(os, rows);
+        const __m256i full = _mm256_cmpeq_epi16(_mm256_or_si256(xs, os), _mm256_set1_epi16(Board::FullMask));
+        __m256i result = _mm256_blendv_epi8(_mm256_set1_epi16(NO_ONE), _mm256_set1_epi16(TIES), full);
+        result = _mm256_blendv_epi8(result, _mm256_set1_epi16(O), winO);
+        result = _mm256_blendv_epi8(result, _mm256_set1_epi16(X), winX);
+        // 16 lanes of 16 bits to 16 bytes
+        const __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+        _mm_storeu_si128((__m128i*)(results + i), packed);
+    }
+    return i;
+}
+#endif
+
+using BatchKernel = size_t (*)(const uint16_t*, const uint16_t*, uint8_t*, size_t);
+
+struct BatchPath
+{
+    BatchKernel kernel;
+    const char* name;
+};
+
+const BatchPath& SelectPath()
+{
+    static const BatchPath path = []() -> BatchPath {
+#ifdef BATCH_WINNER_AVX2
+        if (__builtin_cpu_supports("avx2"))
+            return {BatchWinnersAvx2, "avx2"};
+#endif
+        return {BatchWinnersSse2, "sse2"};
+    }();
+    return path;
+}
+}  // namespace
+
+void BatchWinners(const uint16_t* x, const uint16_t* o, uint8_t* results, size_t count)
+{
+    size_t done = SelectPath().kernel(x, o, results, count);
+    BatchWinnersScalar(x + done, o + done, results + done, count - done);
+}
+
+const char* BatchWinnersPath()
+{
+    return SelectPath().name;
+}
+#else
+void BatchWinners(const uint16_t* x, const uint16_t* o, uint8_t* results, size_t count)
+{
+    BatchWinnersScalar(x, o, results, count);
+}
+
+const char* BatchWinnersPath()
+{
+    return "scalar";
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Board.h"
+
+// Results for many independent 3x3 boards at once, for rollouts and solver sweeps.
+// The boards come as a structure of arrays: x[i] and o[i] are board i's masks
+// (Board::Pieces), results[i] gets X, O, TIES or NO_ONE, the same as Board::Winner()
+// and checkWinner() on that board. Each board is a 16-bit lane, so the eight
+// Board::WinMasks are tested on 16 boards per AVX2 step (8 per SSE2 register, two at a time).
+// The widest path the CPU supports is picked on the first call; other targets and the
+// leftover boards use the scalar loop.
+void BatchWinners(const uint16_t* x, const uint16_t* o, uint8_t* results, size_t count);
+// the portable loop, always available
+void BatchWinnersScalar(const uint16_t* x, const uint16_t* o, uint8_t* results, size_t count);
+// "avx2", "sse2" or "scalar"
+const char* BatchWinnersPath();
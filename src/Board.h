@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "GameTypes.h"
+
+// 3x3 game state: one 9-bit mask per side, bit n is cell n.
+// Copying a Board is copying 4 bytes, nothing here touches the heap.
+class Board
+{
+public:
+    static constexpr int Cells = 9;
+    static constexpr uint16_t FullMask = 0x1FF;
+    // all possible win rows
+    static constexpr uint16_t WinMasks[8] = {
+        0x007,  // 0 1 2
+        0x038,  // 3 4 5
+        0x1C0,  // 6 7 8
+        0x049,  // 0 3 6
+        0x092,  // 1 4 7
+        0x124,  // 2 5 8
+        0x111,  // 0 4 8
+        0x054   // 2 4 6
+    };
+
+    static Board FromMasks(uint16_t x, uint16_t o)
+    {
+        Board board;
+        board.pieces = {x, o};
+        return board;
+    }
+
+    static constexpr int Size() { return 3; }
+    static constexpr int WinLength() { return 3; }
+    static constexpr int CellCount() { return Cells; }
+
+    void Reset() { pieces = {0, 0}; }
+    bool IsLegal(int cell) const { return cell >= 0 && cell < Cells && !((Occupied() >> cell) & 1); }
+    void MakeMove(int cell, CellValue player) { pieces[player - X] |= uint16_t(1u << cell); }
+    void UndoMove(int cell)
+    {
+        pieces[0] &= uint16_t(~(1u << cell));
+        pieces[1] &= uint16_t(~(1u << cell));
+    }
+
+    CellValue At(int cell) const
+    {
+        if ((pieces[0] >> cell) & 1) return X;
+        if ((pieces[1] >> cell) & 1) return O;
+        return EMPTY;
+    }
+    uint16_t Pieces(CellValue player) const { return pieces[player - X]; }
+    uint16_t Occupied() const { return pieces[0] | pieces[1]; }
+    uint16_t EmptyCells() const { return uint16_t(~Occupied() & FullMask); }
+    int MoveCount() const { return PopCount(Occupied()); }
+
+    // X, O, TIES or NO_ONE if the game goes on
+    CellValue Winner() const
+    {
+        if (HasLine(pieces[0])) return X;
+        if (HasLine(pieces[1])) return O;
+        if (Occupied() == FullMask) return TIES;
+        return NO_ONE;
+    }
+
+    static bool HasLine(uint16_t mask) { return (LineTable[mask >> 6] >> (mask & 63)) & 1; }
+    static int PopCount(uint16_t mask) { return __builtin_popcount(mask); }
+
+    bool operator==(const Board& other) const { return pieces == other.pieces; }
+    bool operator!=(const Board& other) const { return pieces != other.pieces; }
+
+private:
+    static const std::array<uint64_t, 8> LineTable;
+
+    std::array<uint16_t, 2> pieces = {0, 0};
+};
+
+// bit m of the table is set when mask m contains a full win row
+constexpr std::array<uint64_t, 8> BuildLineTable()
+{
+    std::array<uint64_t, 8> table = {};
+    for (unsigned mask = 0; mask <= Board::FullMask; ++mask)
+    {
+        for (uint16_t row : Board::WinMasks)
+        {
+            if ((mask & row) == row)
+            {
+                table[mask >> 6] |= uint64_t(1) << (mask & 63);
+                break;
+            }
+        }
+    }
+    return table;
+}
+inline constexpr std::array<uint64_t, 8> Board::LineTable = BuildLineTable();
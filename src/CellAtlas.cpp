@@ -0,0 +1,47 @@
+#include "CellAtlas.h"
+
+void CellAtlas::Load(int size)
+{
+    Unload();
+    cellSize = size;
+    // sprites side by side in one row, so flipping the render texture keeps them in place
+    texture = LoadRenderTexture(cellSize * SPRITE_COUNT, cellSize);
+    BeginTextureMode(texture);
+    ClearBackground(BLANK);
+    for (int i = 0; i < SPRITE_COUNT; i++)
+        DrawSprite((Sprite)i, i * cellSize, cellSize);
+    EndTextureMode();
+    loaded = true;
+}
+
+void CellAtlas::Unload()
+{
+    if (!loaded)
+        return;
+    UnloadRenderTexture(texture);
+    loaded = false;
+}
+
+void CellAtlas::Draw(Sprite sprite, int x, int y) const
+{
+    // render textures are stored bottom-up, hence the negative source height
+    Rectangle source = {(float)(sprite * cellSize), 0.0f, (float)cellSize, -(float)cellSize};
+    Rectangle dest = {(float)x, (float)y, (float)cellSize, (float)cellSize};
+    DrawTexturePro(texture.texture, source, dest, Vector2{0.0f, 0.0f}, 0.0f, WHITE);
+}
+
+void CellAtlas::DrawSprite(Sprite sprite, int x, int size)
+{
+    bool win = (sprite == SPRITE_X_WIN || sprite == SPRITE_O_WIN);
+    DrawRectangle(x, 0, size, size, win ? GREEN : LIGHTGRAY);
+    DrawRectangleLines(x, 0, size, size, RAYWHITE);
+    if (sprite == SPRITE_X || sprite == SPRITE_X_WIN)
+    {
+        DrawLine(x, 0, x + size, size, RED);
+        DrawLine(x, size, x + size, 0, RED);
+    }
+    else if (sprite == SPRITE_O || sprite == SPRITE_O_WIN)
+    {
+        DrawCircleLines(x + size / 2, size / 2, size / 2 - size / 20, BLUE);
+    }
+}
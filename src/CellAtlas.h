@@ -0,0 +1,38 @@
+#pragma once
+#include <raylib-cpp.hpp>
+
+// One render texture holding a pre-drawn sprite for every look a cell can have.
+// Every cell is then a textured quad from the same texture, so rlgl batches the
+// whole board into a single draw call whatever the board size.
+class CellAtlas
+{
+public:
+    enum Sprite
+    {
+        SPRITE_EMPTY,
+        SPRITE_X,
+        SPRITE_O,
+        SPRITE_X_WIN,
+        SPRITE_O_WIN,
+        SPRITE_COUNT
+    };
+
+    CellAtlas() = default;
+    ~CellAtlas() { Unload(); }
+    CellAtlas(const CellAtlas&) = delete;
+    CellAtlas& operator=(const CellAtlas&) = delete;
+
+    // needs a window (GL context); sprites are cellSize x cellSize
+    void Load(int cellSize);
+    void Unload();
+    bool IsLoaded() const { return loaded; }
+
+    void Draw(Sprite sprite, int x, int y) const;
+
+private:
+    static void DrawSprite(Sprite sprite, int x, int size);
+
+    RenderTexture2D texture = {};
+    int cellSize = 0;
+    bool loaded = false;
+};
@@ -0,0 +1,460 @@
+#include "Deepening.h"
+#include <algorithm>
+
+namespace
+{
+const int Infinity = DeepeningSearch::WinScore + 1;
+// scores this close to WinScore are wins found ply moves down the line
+const int WinBound = DeepeningSearch::WinScore - 64;
+
+// win scores are stored relative to the node so they stay right wherever it is reached from
+int ToTable(int score, int ply)
+{
+    return (score >= WinBound) ? score + ply : (score <= -WinBound) ? score - ply : score;
+}
+
+int FromTable(int score, int ply)
+{
+    return (score >= WinBound) ? score - ply : (score <= -WinBound) ? score + ply : score;
+}
+}  // namespace
+
+DeepeningSearch::DeepeningSearch(const DeepeningConfig& config)
+    : config(config), stopFlag(nullptr), table(nullptr), helperStop(false), size(3), eval(0), followPv(false),
+      lastMoveCount(-1), lastPlayer(EMPTY), nodes(0), aborted(false), timed(false), helper(false)
+{
+}
+
+void DeepeningSearch::SetConfig(const DeepeningConfig& newConfig)
+{
+    // a new budget takes effect with the next search
+    if (newConfig.tableMegabytes != config.tableMegabytes)
+        ownTable.reset();
+    config = newConfig;
+}
+
+void DeepeningSearch::Prepare(const DynamicBoard& position, const WinTracker& positionTracker)
+{
+    root = position;
+    tracker = positionTracker;
+    size = root.Size();
+    const int cells = root.CellCount();
+
+    // an open line is worth 8x more per stone, capped so a sum over all lines fits an int
+    weights.assign(root.WinLength() + 1, 0);
+    for (int stones = 1; stones <= root.WinLength(); ++stones)
+        weights[stones] = 1 << std::min(3 * stones, 16);
+    eval = 0;
+    for (int line = 0; line < tracker.LineCount(); ++line)
+        eval += LineValue(line);
+
+    near.assign(cells, 0);
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        if (root.At(cell) == EMPTY)
+            continue;
+        int row = cell / size, col = cell % size;
+        for (int r = std::max(row - 1, 0); r <= std::min(row + 1, size - 1); ++r)
+        {
+            for (int c = std::max(col - 1, 0); c <= std::min(col + 1, size - 1); ++c)
+                near[r * size + c]++;
+        }
+    }
+
+    moveBuffer.resize(size_t(MaxPly) * cells);
+    orderBuffer.resize(cells);
+    for (std::vector<uint32_t>& table : history)
+    {
+        // older cutoffs count half, the position has moved on
+        table.resize(cells, 0);
+        for (uint32_t& value : table)
+            value /= 2;
+    }
+    for (int ply = 0; ply < MaxPly; ++ply)
+        killers[ply][0] = killers[ply][1] = -1;
+}
+
+int DeepeningSearch::LineValue(int line) const
+{
+    int x = tracker.Stones(line, X);
+    int o = tracker.Stones(line, O);
+    if (o == 0)
+        return weights[x];
+    if (x == 0)
+        return -weights[o];
+    return 0;
+}
+
+template <typename B>
+void DeepeningSearch::Play(B& board, int cell, CellValue player)
+{
+    for (const uint16_t* line = tracker.LinesBegin(cell); line != tracker.LinesEnd(cell); ++line)
+        eval -= LineValue(*line);
+    tracker.MakeMove(cell, player);
+    board.MakeMove(cell, player);
+    for (const uint16_t* line = tracker.LinesBegin(cell); line != tracker.LinesEnd(cell); ++line)
+        eval += LineValue(*line);
+
+    int row = cell / size, col = cell % size;
+    for (int r = std::max(row - 1, 0); r <= std::min(row + 1, size - 1); ++r)
+    {
+        for (int c = std::max(col - 1, 0); c <= std::min(col + 1, size - 1); ++c)
+            near[r * size + c]++;
+    }
+}
+
+template <typename B>
+void DeepeningSearch::Undo(B& board, int cell, CellValue player)
+{
+    for (const uint16_t* line = tracker.LinesBegin(cell); line != tracker.LinesEnd(cell); ++line)
+        eval -= LineValue(*line);
+    tracker.UndoMove(cell, player);
+    board.UndoMove(cell);
+    for (const uint16_t* line = tracker.LinesBegin(cell); line != tracker.LinesEnd(cell); ++line)
+        eval += LineValue(*line);
+
+    int row = cell / size, col = cell % size;
+    for (int r = std::max(row - 1, 0); r <= std::min(row + 1, size - 1); ++r)
+    {
+        for (int c = std::max(col - 1, 0); c <= std::min(col + 1, size - 1); ++c)
+            near[r * size + c]--;
+    }
+}
+
+template <typename B>
+int DeepeningSearch::Generate(const B& board, int ply, CellValue player, int* out, int tableMove)
+{
+    const int cells = board.CellCount();
+    const CellValue opponent = Opponent(player);
+    int count = 0;
+    if (board.MoveCount() == 0)
+    {
+        out[count++] = (size / 2) * size + size / 2;
+        return count;
+    }
+    // small boards search every cell, large ones only cells next to a stone
+    const bool all = cells <= 25;
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        if (board.At(cell) == EMPTY && (all || near[cell] > 0))
+            out[count++] = cell;
+    }
+
+    // a win in one is the only move worth trying, a loss in one leaves only the blocks
+    for (int i = 0; i < count; ++i)
+    {
+        if (tracker.WouldWin(out[i], player))
+        {
+            out[0] = out[i];
+            return 1;
+        }
+    }
+    int blocks = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (tracker.WouldWin(out[i], opponent))
+            out[blocks++] = out[i];
+    }
+    if (blocks > 0)
+        return blocks;
+
+    const int pvMove = (followPv && ply < (int)previousPv.size()) ? previousPv[ply] : -1;
+    const std::vector<uint32_t>& cutoffs = history[player - X];
+    for (int i = 0; i < count; ++i)
+    {
+        int cell = out[i];
+        int score;
+        if (cell == pvMove)
+            score = 1 << 30;
+        else if (cell == tableMove)
+            score = 3 << 28;
+        else if (cell == killers[ply][0])
+            score = 1 << 29;
+        else if (cell == killers[ply][1])
+            score = 1 << 28;
+        else
+        {
+            // attack and defence value of the lines through the cell
+            score = int(std::min<uint32_t>(cutoffs[cell], 1 << 20)) << 6;
+            for (const uint16_t* line = tracker.LinesBegin(cell); line != tracker.LinesEnd(cell); ++line)
+            {
+                int mine = tracker.Stones(*line, player);
+                int theirs = tracker.Stones(*line, opponent);
+                if (theirs == 0)
+                    score += weights[mine];
+                if (mine == 0)
+                    score += weights[theirs];
+            }
+        }
+        orderBuffer[i] = score;
+    }
+    // insertion sort, candidate lists are short
+    for (int i = 1; i < count; ++i)
+    {
+        int cell = out[i];
+        int score = orderBuffer[i];
+        int j = i - 1;
+        for (; j >= 0 && orderBuffer[j] < score; --j)
+        {
+            out[j + 1] = out[j];
+            orderBuffer[j + 1] = orderBuffer[j];
+        }
+        out[j + 1] = cell;
+        orderBuffer[j + 1] = score;
+    }
+    return count;
+}
+
+bool DeepeningSearch::TimeUp()
+{
+    if (stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed))
+        return true;
+    return timed && Clock::now() >= deadline;
+}
+
+template <typename B>
+int DeepeningSearch::Search(B& board, int depth, int ply, int alpha, int beta, CellValue player)
+{
+    nodes++;
+    pvLength[ply] = ply;
+    if ((nodes & 1023) == 0 && TimeUp())
+        aborted = true;
+    if (aborted)
+        return 0;
+
+    CellValue result = tracker.Result();
+    if (result == Opponent(player))
+        return -(WinScore - ply);
+    if (result == TIES)
+        return 0;
+    if (depth == 0 || ply >= MaxPly - 1)
+        return Evaluate(player);
+
+    // a deep enough result for this position ends the node, any result gives a move to try first
+    const uint64_t nodeKey = board.Key(player);
+    int tableMove = -1;
+    TTData entry;
+    if (table != nullptr && table->Probe(nodeKey, entry, tableCounters))
+    {
+        tableMove = entry.move;
+        if (ply > 0 && entry.depth >= depth)
+        {
+            int score = FromTable(entry.score, ply);
+            if (entry.bound == TT_EXACT || (entry.bound == TT_LOWER && score >= beta) || (entry.bound == TT_UPPER && score <= alpha))
+                return score;
+        }
+    }
+    const int alphaStart = alpha;
+
+    int* moves = &moveBuffer[size_t(ply) * board.CellCount()];
+    const bool onPv = followPv && ply < (int)previousPv.size();
+    int count = Generate(board, ply, player, moves, tableMove);
+    if (count == 0)
+        return Evaluate(player);
+    if (tracker.WouldWin(moves[0], player))
+    {
+        pv[ply][ply] = moves[0];
+        pvLength[ply] = ply + 1;
+        return WinScore - ply - 1;
+    }
+
+    int best = -Infinity;
+    int bestMove = -1;
+    for (int i = 0; i < count; ++i)
+    {
+        int move = moves[i];
+        followPv = onPv && move == previousPv[ply];
+        Play(board, move, player);
+        int score = -Search(board, depth - 1, ply + 1, -beta, -alpha, Opponent(player));
+        Undo(board, move, player);
+        followPv = false;
+        if (aborted)
+            return 0;
+        if (score > best)
+        {
+            best = score;
+            bestMove = move;
+            if (score > alpha)
+            {
+                alpha = score;
+                pv[ply][ply] = move;
+                for (int next = ply + 1; next < pvLength[ply + 1]; ++next)
+                    pv[ply][next] = pv[ply + 1][next];
+                pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+            }
+        }
+        if (alpha >= beta)
+        {
+            if (move != killers[ply][0])
+            {
+                killers[ply][1] = killers[ply][0];
+                killers[ply][0] = move;
+            }
+            history[player - X][move] += uint32_t(depth * depth);
+            break;
+        }
+    }
+    if (table != nullptr)
+    {
+        TTBound bound = (best <= alphaStart) ? TT_UPPER : (best >= beta) ? TT_LOWER : TT_EXACT;
+        table->Store(nodeKey, ToTable(best, ply), bestMove, depth, bound, tableCounters);
+    }
+    return best;
+}
+
+int DeepeningSearch::BestMove(const DynamicBoard& position, const WinTracker& positionTracker, CellValue player)
+{
+    depths.clear();
+    tableCounters = TTCounters();
+    tableStats = TTCounters();
+    if (positionTracker.Result() != NO_ONE)
+        return -1;
+    started = Clock::now();
+    timed = config.timeMs > 0.0;
+    deadline = started + std::chrono::microseconds(int64_t(config.timeMs * 1000.0));
+    Prepare(position, positionTracker);
+
+    // the game went the way the last search expected: its line is a good first guess
+    previousPv.clear();
+    if (config.reusePv && player == lastPlayer && position.MoveCount() == lastMoveCount + 2 && lastPv.size() > 2 &&
+        position.At(lastPv[0]) == player && position.At(lastPv[1]) == Opponent(player))
+        previousPv.assign(lastPv.begin() + 2, lastPv.end());
+
+    // a win, a single block or a single cell needs no search
+    followPv = false;
+    int rootMoves = Generate(root, 0, player, &moveBuffer[0], -1);
+    int best = moveBuffer[0];
+    if (rootMoves == 1)
+        return best;
+
+    // the table is large, it is allocated by the first search that needs it
+    if (!ownTable && config.tableMegabytes > 0)
+        ownTable = std::make_unique<TranspositionTable>(config.tableMegabytes);
+    table = ownTable.get();
+    if (table != nullptr)
+        table->NewSearch();
+    StartHelpers(position, positionTracker, player);
+    int searched = Iterate(player, 1);
+    StopHelpers();
+    if (searched >= 0)
+        best = searched;
+
+    tableStats = tableCounters;
+    for (const std::unique_ptr<DeepeningSearch>& helper : helpers)
+        tableStats.Add(helper->tableCounters);
+    lastPv = previousPv;
+    lastMoveCount = position.MoveCount();
+    lastPlayer = player;
+    return best;
+}
+
+int DeepeningSearch::Iterate(CellValue player, int firstDepth)
+{
+    return WithGeometry(root.GetGeometry(), [&](auto geometry) {
+        GenericBoard<decltype(geometry)> board(root, geometry);
+        return Iterate(board, player, firstDepth);
+    });
+}
+
+template <typename B>
+int DeepeningSearch::Iterate(B& board, CellValue player, int firstDepth)
+{
+    int best = -1;
+    nodes = 0;
+    aborted = false;
+    uint64_t previousNodes = 0;
+    int previousScore = 0;
+    for (int depth = firstDepth; depth <= config.maxDepth && depth < MaxPly; ++depth)
+    {
+        uint64_t startNodes = nodes;
+        Clock::time_point depthStart = Clock::now();
+        int window = config.aspirationWindow;
+        bool narrow = depth > firstDepth && window > 0 && std::abs(previousScore) < WinScore / 2;
+        int alpha = narrow ? previousScore - window : -Infinity;
+        int beta = narrow ? previousScore + window : Infinity;
+        int researches = 0;
+        int score;
+        for (;;)
+        {
+            followPv = true;
+            score = Search(board, depth, 0, alpha, beta, player);
+            if (aborted)
+                break;
+            // outside the window: search again with that side opened
+            if (score <= alpha && alpha > -Infinity)
+                alpha = -Infinity;
+            else if (score >= beta && beta < Infinity)
+                beta = Infinity;
+            else
+                break;
+            researches++;
+        }
+        if (aborted)
+            break;
+
+        best = pv[0][0];
+        previousPv.assign(pv[0], pv[0] + pvLength[0]);
+        previousScore = score;
+        uint64_t depthNodes = nodes - startNodes;
+        DepthStats stats;
+        stats.depth = depth;
+        stats.nodes = depthNodes;
+        stats.ms = std::chrono::duration<double, std::milli>(Clock::now() - depthStart).count();
+        stats.branching = previousNodes > 0 ? double(depthNodes) / double(previousNodes) : 0.0;
+        stats.score = score;
+        stats.bestMove = best;
+        stats.researches = researches;
+        depths.push_back(stats);
+        previousNodes = depthNodes;
+
+        // a forced result won't change with more depth
+        if (std::abs(score) >= WinScore - MaxPly)
+            break;
+        // the next depth costs several times this one, don't start what can't finish;
+        // helpers keep going until the main search is done
+        if (!helper && timed && std::chrono::duration<double, std::milli>(Clock::now() - started).count() * 2.0 > config.timeMs)
+            break;
+    }
+    return best;
+}
+
+void DeepeningSearch::StartHelpers(const DynamicBoard& position, const WinTracker& positionTracker, CellValue player)
+{
+    const int count = std::max(config.threads - 1, 0);
+    while ((int)helpers.size() < count)
+    {
+        DeepeningConfig helperConfig = config;
+        helperConfig.threads = 1;
+        helperConfig.tableMegabytes = 0;
+        helperConfig.reusePv = false;
+        helpers.push_back(std::make_unique<DeepeningSearch>(helperConfig));
+        helpers.back()->helper = true;
+        helpers.back()->SetStopFlag(&helperStop);
+    }
+    helperStop.store(false, std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i)
+    {
+        DeepeningSearch* search = helpers[i].get();
+        search->table = table;
+        search->config.maxDepth = config.maxDepth;
+        search->config.aspirationWindow = config.aspirationWindow;
+        search->timed = timed;
+        search->deadline = deadline;
+        search->started = started;
+        search->tableCounters = TTCounters();
+        search->depths.clear();
+        search->Prepare(position, positionTracker);
+        search->previousPv.clear();
+        // every other helper runs a depth ahead so the threads don't all search the same tree
+        const int firstDepth = 1 + (i & 1);
+        helperThreads.emplace_back([search, player, firstDepth]() { search->Iterate(player, firstDepth); });
+    }
+}
+
+void DeepeningSearch::StopHelpers()
+{
+    helperStop.store(true, std::memory_order_relaxed);
+    for (std::thread& thread : helperThreads)
+        thread.join();
+    helperThreads.clear();
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "GameTypes.h"
+#include "GenericBoard.h"
+#include "TranspositionTable.h"
+#include "WinTracker.h"
+
+struct DeepeningConfig
+{
+    double timeMs = 500.0;  // wall clock per move, 0: limited by maxDepth only
+    int maxDepth = 32;
+    int aspirationWindow = 64;  // half width around the previous depth's score, 0 disables
+    bool reusePv = true;  // seed move ordering with the last search's expected continuation
+    int threads = 1;  // more than one: helper threads search the same position (lazy SMP)
+    size_t tableMegabytes = 16;  // transposition table shared by the threads, 0 disables it
+};
+
+// one completed iteration
+struct DepthStats
+{
+    int depth;
+    uint64_t nodes;
+    double ms;
+    double branching;  // nodes of this depth / nodes of the previous one
+    int score;
+    int bestMove;
+    int researches;  // aspiration window failures
+};
+
+// Anytime alpha-beta for large boards: iterative deepening until the time budget runs out,
+// the last completed depth gives the move.
+// Leaves are scored from the K-cell lines (open lines weighted by how full they are),
+// kept up to date per move from the WinTracker line counts.
+// Move ordering: previous principal variation, two killer moves per ply, then a history
+// table of moves that caused cutoffs, then the line score of the cell.
+// Only cells next to a stone are searched, a win in one is taken and a loss in one forces the block.
+// Results go to a transposition table. With more threads, helpers run the same deepening
+// loop (every other one a depth ahead) and only share the table, which lets the main
+// thread cut off positions they already searched.
+class DeepeningSearch
+{
+public:
+    static constexpr int WinScore = 1 << 30;
+
+    explicit DeepeningSearch(const DeepeningConfig& config = DeepeningConfig());
+
+    void SetConfig(const DeepeningConfig& config);
+    const DeepeningConfig& Config() const { return config; }
+    void SetStopFlag(const std::atomic<bool>* flag) { stopFlag = flag; }
+
+    // best cell for player, -1 if the game is already over
+    int BestMove(const DynamicBoard& board, const WinTracker& tracker, CellValue player);
+    // iterations of the last BestMove
+    const std::vector<DepthStats>& Stats() const { return depths; }
+    // table use of the last BestMove over all threads
+    const TTCounters& TableStats() const { return tableStats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static const int MaxPly = 64;
+
+    void Prepare(const DynamicBoard& board, const WinTracker& tracker);
+    // the deepening loop from firstDepth on, the best move of the last completed depth or -1;
+    // it runs on root under its compile-time geometry when the size has one (see WithGeometry)
+    int Iterate(CellValue player, int firstDepth);
+    template <typename B>
+    int Iterate(B& board, CellValue player, int firstDepth);
+    void StartHelpers(const DynamicBoard& position, const WinTracker& tracker, CellValue player);
+    void StopHelpers();
+    template <typename B>
+    int Search(B& board, int depth, int ply, int alpha, int beta, CellValue player);
+    template <typename B>
+    int Generate(const B& board, int ply, CellValue player, int* out, int tableMove);
+    template <typename B>
+    void Play(B& board, int cell, CellValue player);
+    template <typename B>
+    void Undo(B& board, int cell, CellValue player);
+    int LineValue(int line) const;  // X minus O
+    int Evaluate(CellValue player) const { return (player == X) ? eval : -eval; }
+    bool TimeUp();
+
+    DeepeningConfig config;
+    const std::atomic<bool>* stopFlag;
+
+    TranspositionTable* table;  // this search's own or the main search's
+    std::unique_ptr<TranspositionTable> ownTable;
+    TTCounters tableCounters;
+    TTCounters tableStats;
+    std::vector<std::unique_ptr<DeepeningSearch>> helpers;
+    std::vector<std::thread> helperThreads;
+    std::atomic<bool> helperStop;
+
+    DynamicBoard root;  // the searched position
+    WinTracker tracker;
+    int size;
+    int eval;  // sum of LineValue over all lines
+    std::vector<int> weights;  // by stones in an otherwise empty line
+    std::vector<uint8_t> near;  // stones within one cell
+    std::vector<int> moveBuffer;  // MaxPly rows of CellCount moves
+    std::vector<int> orderBuffer;
+    std::vector<uint32_t> history[2];
+    int killers[MaxPly][2];
+    int pv[MaxPly][MaxPly];
+    int pvLength[MaxPly];
+    std::vector<int> previousPv;  // expected line from the root, for ordering
+    bool followPv;  // the current node lies on previousPv
+
+    // the last search's line, to reuse if the game followed it
+    std::vector<int> lastPv;
+    int lastMoveCount;
+    CellValue lastPlayer;
+
+    uint64_t nodes;
+    bool aborted;
+    Clock::time_point deadline;
+    bool timed;
+    Clock::time_point started;
+    bool helper;  // runs for the main search until it is stopped
+    std::vector<DepthStats> depths;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Remembers a key for what was last drawn in each slot (a cell, a button) of a retained
+// render target, so a frame only redraws the slots whose key changed.
+class DirtyTracker
+{
+public:
+    explicit DirtyTracker(int count = 0) : keys(count, Invalid) {}
+
+    void Resize(int count) { keys.assign(count, Invalid); }
+    // everything is redrawn on the next Update
+    void Invalidate() { keys.assign(keys.size(), Invalid); }
+
+    // true when the slot must be redrawn, the key is stored as drawn
+    bool Update(int slot, uint32_t key)
+    {
+        if (keys[slot] == key)
+            return false;
+        keys[slot] = key;
+        return true;
+    }
+
+private:
+    static const uint32_t Invalid = 0xFFFFFFFFu;
+    std::vector<uint32_t> keys;
+};
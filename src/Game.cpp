@@ -0,0 +1,80 @@
+#include "Game.h"
+#include "Log.h"
+
+GameSession::GameSession(int size, int winLength)
+    : state(MAINMENU), firstPiece(X), board(DynamicGeometry(size, winLength)), tracker(size, winLength)
+{
+    moves.reserve(board.CellCount());
+}
+
+void GameSession::Reset()
+{
+    board.Reset();
+    tracker.Reset();
+    moves.clear();
+    state = MAINMENU;
+}
+
+void GameSession::Start(CellValue firstPiece)
+{
+    this->firstPiece = firstPiece;
+    state = (firstPiece == X) ? PLAYER_X_MOVE : PLAYER_O_MOVE;
+}
+
+bool GameSession::PlayMove(int cell)
+{
+    CellValue piece = ToMove();
+    if (piece == EMPTY || !board.IsLegal(cell))
+        return false;
+    board.MakeMove(cell, piece);
+    tracker.MakeMove(cell, piece);
+    moves.push_back(cell);
+    announceWinner(checkWinner(tracker), state);
+    return true;
+}
+
+void GameSession::Finish()
+{
+    state = GAME_FINISHED;
+}
+
+CellValue checkWinner(const WinTracker& tracker)
+{
+    CellValue winner = tracker.Result();
+    if (winner == X || winner == O)
+    {
+        DEBUG_LOG("Winner: %d", winner);
+        return winner;
+    }
+    if (winner == TIES)
+        return TIES;
+    TRACE_LOG("CheckWinner");
+    return NO_ONE;
+}
+
+GameState announceWinner(CellValue winner, GameState& currentGameState)
+{
+
+    if (winner == X)
+    {
+        currentGameState = PLAYER_X_WIN;
+        return currentGameState;
+    }
+    else if (winner == O)
+    {
+        currentGameState = PLAYER_O_WIN;
+        return currentGameState;
+    }
+    else if (winner == TIES)
+    {
+        currentGameState = TIE;
+        return currentGameState;
+    }
+    else if (winner == NO_ONE)
+    {
+        currentGameState = (currentGameState == PLAYER_O_MOVE) ? PLAYER_X_MOVE : PLAYER_O_MOVE;
+        return currentGameState;
+    }
+    else
+        return currentGameState;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "GameTypes.h"
+#include "GenericBoard.h"
+#include "WinTracker.h"
+
+// The game rules and GameState transitions without any rendering or input.
+// The window front end and the headless drivers both play through a session.
+class GameSession
+{
+public:
+    GameSession(int size = 3, int winLength = 3);
+
+    // back to the main menu with an empty board
+    void Reset();
+    // leaves the menu, firstPiece moves first
+    void Start(CellValue firstPiece);
+    // plays cell for the side to move, false if the move is illegal or no one is to move
+    bool PlayMove(int cell);
+    // the result has been shown, wait for the play again choice
+    void Finish();
+
+    GameState State() const { return state; }
+    bool IsPlaying() const { return state == PLAYER_X_MOVE || state == PLAYER_O_MOVE; }
+    bool IsDecided() const { return state == PLAYER_X_WIN || state == PLAYER_O_WIN || state == TIE; }
+    CellValue ToMove() const { return (state == PLAYER_X_MOVE) ? X : (state == PLAYER_O_MOVE) ? O
+                                                                                               : EMPTY; }
+    CellValue Result() const { return tracker.Result(); }
+
+    const DynamicBoard& GetBoard() const { return board; }
+    const WinTracker& GetTracker() const { return tracker; }
+    // the moves of the current game in order, and who made the first one
+    const std::vector<int>& Moves() const { return moves; }
+    CellValue FirstPiece() const { return firstPiece; }
+
+private:
+    GameState state;
+    CellValue firstPiece;
+    std::vector<int> moves;
+    DynamicBoard board;
+    WinTracker tracker;
+};
+
+CellValue checkWinner(const WinTracker& tracker);
+
+GameState announceWinner(CellValue winner, GameState& currentGameState);
@@ -0,0 +1,339 @@
+#include "GameRecord.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include "GenericBoard.h"
+#include "Log.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+void PutU16(std::vector<uint8_t>& out, uint32_t value)
+{
+    out.push_back(uint8_t(value));
+    out.push_back(uint8_t(value >> 8));
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t value)
+{
+    PutU16(out, value);
+    PutU16(out, value >> 16);
+}
+
+void PutU64(std::vector<uint8_t>& out, uint64_t value)
+{
+    PutU32(out, uint32_t(value));
+    PutU32(out, uint32_t(value >> 32));
+}
+
+uint32_t GetU16(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+uint32_t GetU32(const uint8_t* p)
+{
+    return GetU16(p) | (GetU16(p + 2) << 16);
+}
+
+uint64_t GetU64(const uint8_t* p)
+{
+    return GetU32(p) | (uint64_t(GetU32(p + 4)) << 32);
+}
+
+size_t MoveBytes(int size)
+{
+    return (size * size > 256) ? 2 : 1;
+}
+}  // namespace
+
+GameRecord MakeRecord(const GameSession& session, RecordSource source, uint64_t startMs, uint32_t durationMs)
+{
+    GameRecord record;
+    FillRecord(session, source, startMs, durationMs, record);
+    return record;
+}
+
+void FillRecord(const GameSession& session, RecordSource source, uint64_t startMs, uint32_t durationMs, GameRecord& record)
+{
+    record.size = session.GetBoard().Size();
+    record.winLength = session.GetBoard().WinLength();
+    record.first = session.FirstPiece();
+    record.result = session.Result();
+    record.source = source;
+    record.startMs = startMs;
+    record.durationMs = durationMs;
+    record.moves.assign(session.Moves().begin(), session.Moves().end());
+}
+
+uint64_t RecordClockMs()
+{
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+}
+
+bool GameRecordWriter::Open(const char* filePath, uint64_t limit, size_t bufferBytes)
+{
+    Close();
+    path.assign(filePath, filePath + strlen(filePath) + 1);
+    maxBytes = limit;
+    bufferLimit = bufferBytes;
+    buffer.clear();
+    buffer.reserve(bufferBytes + RecordHeaderBytes + 2 * MaxBoardSize * MaxBoardSize);
+    return OpenFile();
+}
+
+bool GameRecordWriter::OpenFile()
+{
+    {
+        // drop a record cut short by a crash so new records stay readable after it;
+        // a corrupt record with games after it is left alone and nothing is appended
+        GameRecordReader reader;
+        if (reader.Open(path.data()))
+        {
+            RecordView view;
+            while (reader.Next(view))
+                ;
+            size_t valid = reader.Offset();
+            size_t bytes = reader.Bytes();
+            bool partial = reader.AtPartialRecord();
+            reader.Close();
+            if (valid < bytes && !partial)
+            {
+                WARN_LOG("Corrupt game record at byte %zu of %s, not appending to it", valid, path.data());
+                return false;
+            }
+            std::error_code error;
+            if (valid < bytes)
+                std::filesystem::resize_file(path.data(), valid, error);
+        }
+    }
+    // "a+" so an existing header can be checked, writes always go to the end
+    file = fopen(path.data(), "a+b");
+    if (file == nullptr)
+        return false;
+    fseek(file, 0, SEEK_END);
+    long end = ftell(file);
+    fileBytes = end > 0 ? uint64_t(end) : 0;
+    if (fileBytes == 0)
+    {
+        std::vector<uint8_t> header;
+        PutU32(header, Magic);
+        PutU32(header, Version);
+        if (fwrite(header.data(), 1, header.size(), file) != header.size())
+        {
+            Close();
+            return false;
+        }
+        fileBytes = header.size();
+        return true;
+    }
+    uint8_t header[HeaderBytes];
+    fseek(file, 0, SEEK_SET);
+    bool ok = fread(header, 1, HeaderBytes, file) == HeaderBytes && GetU32(header) == Magic && GetU32(header + 4) == Version;
+    fseek(file, 0, SEEK_END);
+    if (!ok)
+    {
+        // not ours or an older version, never append to it
+        fclose(file);
+        file = nullptr;
+    }
+    return ok;
+}
+
+bool GameRecordWriter::Write(const GameRecord& record)
+{
+    if (file == nullptr)
+        return false;
+    buffer.push_back(uint8_t(record.size));
+    buffer.push_back(uint8_t(record.winLength));
+    buffer.push_back(uint8_t(record.first));
+    buffer.push_back(uint8_t(record.result));
+    PutU16(buffer, uint32_t(record.moves.size()));
+    buffer.push_back(uint8_t(record.source));
+    buffer.push_back(0);
+    PutU64(buffer, record.startMs);
+    PutU32(buffer, record.durationMs);
+    if (MoveBytes(record.size) == 2)
+    {
+        for (int move : record.moves)
+            PutU16(buffer, uint32_t(move));
+    }
+    else
+    {
+        for (int move : record.moves)
+            buffer.push_back(uint8_t(move));
+    }
+    records++;
+    return buffer.size() < bufferLimit || Flush();
+}
+
+bool GameRecordWriter::Flush()
+{
+    if (file == nullptr)
+        return false;
+    // only what reached the file counts towards rotation, a short write adds less
+    size_t written = buffer.empty() ? 0 : fwrite(buffer.data(), 1, buffer.size(), file);
+    bool ok = written == buffer.size();
+    fileBytes += written;
+    buffer.clear();
+    ok = fflush(file) == 0 && ok;
+    if (ok && maxBytes != 0 && fileBytes >= maxBytes)
+        ok = Rotate();
+    return ok;
+}
+
+bool GameRecordWriter::Rotate()
+{
+    fclose(file);
+    file = nullptr;
+    std::vector<char> old(path.begin(), path.end() - 1);
+    old.push_back('.');
+    old.push_back('1');
+    old.push_back('\0');
+    remove(old.data());
+    if (rename(path.data(), old.data()) != 0)
+        return false;
+    return OpenFile();
+}
+
+void GameRecordWriter::Close()
+{
+    if (file == nullptr)
+        return;
+    Flush();
+    if (file != nullptr)
+        fclose(file);
+    file = nullptr;
+}
+
+bool GameRecordReader::Open(const char* path)
+{
+    Close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart < (LONGLONG)GameRecordWriter::HeaderBytes)
+    {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE map = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = (map != nullptr) ? MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        if (map != nullptr)
+            CloseHandle(map);
+        CloseHandle(handle);
+        return false;
+    }
+    fileHandle = handle;
+    mapping = map;
+    data = static_cast<const uint8_t*>(view);
+    length = size_t(size.QuadPart);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)GameRecordWriter::HeaderBytes)
+    {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+    // records are read front to back exactly once in a scan
+    madvise(view, size_t(info.st_size), MADV_SEQUENTIAL);
+    data = static_cast<const uint8_t*>(view);
+    length = size_t(info.st_size);
+#endif
+    if (GetU32(data) != GameRecordWriter::Magic || GetU32(data + 4) != GameRecordWriter::Version)
+    {
+        Close();
+        return false;
+    }
+    Rewind();
+    return true;
+}
+
+void GameRecordReader::Close()
+{
+    if (data == nullptr)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    CloseHandle(fileHandle);
+    mapping = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(data), length);
+#endif
+    data = nullptr;
+    length = 0;
+    offset = 0;
+}
+
+size_t GameRecordReader::RecordBytes(const uint8_t* p)
+{
+    int size = p[0];
+    int winLength = p[1];
+    int moveCount = int(GetU16(p + 4));
+    if (size < 3 || size > MaxBoardSize || winLength < 3 || winLength > size || (p[2] != X && p[2] != O) ||
+        moveCount > size * size)
+        return 0;
+    // the result and source bytes become enums, anything the writer can't produce is corrupt
+    if (p[3] < X || p[3] > NO_ONE || p[6] > RECORD_HEADLESS)
+        return 0;
+    return GameRecordWriter::RecordHeaderBytes + moveCount * MoveBytes(size);
+}
+
+bool GameRecordReader::Next(RecordView& view)
+{
+    if (data == nullptr || length - offset < GameRecordWriter::RecordHeaderBytes)
+        return false;
+    const uint8_t* p = data + offset;
+    size_t bytes = RecordBytes(p);
+    if (bytes == 0 || length - offset < bytes)
+        return false;
+
+    int size = p[0];
+    int moveCount = int(GetU16(p + 4));
+    view.size = size;
+    view.winLength = p[1];
+    view.first = CellValue(p[2]);
+    view.result = CellValue(p[3]);
+    view.source = RecordSource(p[6]);
+    view.startMs = GetU64(p + 8);
+    view.durationMs = GetU32(p + 16);
+    view.moveCount = moveCount;
+    view.moveBytes = p + GameRecordWriter::RecordHeaderBytes;
+    offset += bytes;
+    return true;
+}
+
+bool GameRecordReader::AtPartialRecord() const
+{
+    if (data == nullptr || offset == length)
+        return false;
+    // a header cut short can't be checked, the crash case is the likely one
+    if (length - offset < GameRecordWriter::RecordHeaderBytes)
+        return true;
+    size_t bytes = RecordBytes(data + offset);
+    return bytes != 0 && length - offset < bytes;
+}
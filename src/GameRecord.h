@@ -0,0 +1,132 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Game.h"
+
+// Append-only binary log of finished games.
+//
+// File: u32 magic "TTTR", u32 version, then records back to back. All integers little endian.
+// Record: u8 size, u8 winLength, u8 first (CellValue), u8 result (CellValue), u16 moveCount,
+//         u8 source, u8 reserved, u64 start (unix ms), u32 duration (ms),
+//         then moveCount cells, one byte each on boards up to 16x16, two bytes above that.
+// A record cut short by a crash stops the reader; the writer cuts it off when it reopens the file.
+enum RecordSource
+{
+    RECORD_HOTSEAT,
+    RECORD_VERSUS_AI,
+    RECORD_HEADLESS
+};
+
+struct GameRecord
+{
+    int size = 3;
+    int winLength = 3;
+    CellValue first = X;
+    CellValue result = NO_ONE;
+    RecordSource source = RECORD_HEADLESS;
+    uint64_t startMs = 0;
+    uint32_t durationMs = 0;
+    std::vector<int> moves;
+};
+
+// settings, moves and result of the session's current game
+GameRecord MakeRecord(const GameSession& session, RecordSource source, uint64_t startMs, uint32_t durationMs);
+// the same into an existing record, reusing its move buffer
+void FillRecord(const GameSession& session, RecordSource source, uint64_t startMs, uint32_t durationMs, GameRecord& record);
+// milliseconds since the unix epoch, for startMs
+uint64_t RecordClockMs();
+
+// Buffers records and appends them to the file in large writes.
+// With a size limit the file is rotated to "<path>.1" once it grows past it, so at most
+// two files' worth of games are kept on disk.
+class GameRecordWriter
+{
+public:
+    static const uint32_t Magic = 0x52545454;  // "TTTR"
+    static const uint32_t Version = 1;
+    static const size_t HeaderBytes = 8;
+    static const size_t RecordHeaderBytes = 20;
+
+    GameRecordWriter() = default;
+    ~GameRecordWriter() { Close(); }
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    // maxBytes == 0 never rotates
+    bool Open(const char* path, uint64_t maxBytes = 0, size_t bufferBytes = 64 * 1024);
+    bool IsOpen() const { return file != nullptr; }
+    bool Write(const GameRecord& record);
+    bool Flush();
+    void Close();
+
+    uint64_t Written() const { return records; }
+
+private:
+    bool OpenFile();
+    bool Rotate();
+
+    FILE* file = nullptr;
+    std::vector<char> path;
+    std::vector<uint8_t> buffer;
+    size_t bufferLimit = 0;
+    uint64_t maxBytes = 0;
+    uint64_t fileBytes = 0;
+    uint64_t records = 0;
+};
+
+// One record inside the mapped file, nothing is copied.
+struct RecordView
+{
+    int size;
+    int winLength;
+    CellValue first;
+    CellValue result;
+    RecordSource source;
+    uint64_t startMs;
+    uint32_t durationMs;
+    int moveCount;
+    const uint8_t* moveBytes;
+
+    int Move(int i) const
+    {
+        return (size * size > 256) ? (moveBytes[i * 2] | (moveBytes[i * 2 + 1] << 8)) : moveBytes[i];
+    }
+};
+
+// Maps a record file read-only and walks it in place.
+class GameRecordReader
+{
+public:
+    GameRecordReader() = default;
+    ~GameRecordReader() { Close(); }
+    GameRecordReader(const GameRecordReader&) = delete;
+    GameRecordReader& operator=(const GameRecordReader&) = delete;
+
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return data != nullptr; }
+
+    // next record, false at the end or at a truncated or corrupt record
+    bool Next(RecordView& view);
+    // after Next returned false: the file ends inside the record at Offset(), which a
+    // crash during a write leaves behind; false at the end or at a corrupt record
+    bool AtPartialRecord() const;
+    void Rewind() { offset = GameRecordWriter::HeaderBytes; }
+    size_t Bytes() const { return length; }
+    // end of the last record read
+    size_t Offset() const { return offset; }
+
+private:
+    // bytes of the record whose header starts at p, 0 if the header is invalid
+    static size_t RecordBytes(const uint8_t* p);
+
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t offset = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapping = nullptr;
+#endif
+};
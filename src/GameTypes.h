@@ -0,0 +1,30 @@
+#pragma once
+
+enum CellValue
+{
+    EMPTY,
+    X,
+    O,
+    TIES,
+    NO_ONE
+};
+enum GameMode
+{
+    HOTSEAT,
+    VERSUS_AI
+};
+enum GameState
+{
+    MAINMENU,
+    PLAYER_X_MOVE,
+    PLAYER_O_MOVE,
+    PLAYER_X_WIN,
+    PLAYER_O_WIN,
+    TIE,
+    GAME_FINISHED
+};
+
+inline CellValue Opponent(CellValue piece)
+{
+    return (piece == X) ? O : X;
+}
@@ -0,0 +1,220 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include "Board.h"
+#include "GameTypes.h"
+#include "Zobrist.h"
+
+// N x N boards with K in a row to win.
+// Cell (row, col) is public cell row * N + col. In the masks every row is N + 1 bits wide,
+// the extra bit is always zero so a run can't wrap from one row into the next. A line of K
+// is then found by AND-ing the side's mask with itself shifted along the four directions,
+// no per-line tables, and a 15x15 board (240 bits per side) still fits in one cache line.
+// The board also keeps its Zobrist key (see Zobrist.h) up to date on every move.
+
+constexpr int MaxBoardSize = 19;
+static_assert(MaxBoardSize * MaxBoardSize <= ZobristCells, "a cell without a Zobrist key");
+
+constexpr int BoardWords(int size)
+{
+    return (size * (size + 1) + 63) / 64;
+}
+
+// size and win length known at compile time: shifts and loops fold to constants
+template <int N, int K>
+struct FixedGeometry
+{
+    static_assert(N >= 3 && N <= MaxBoardSize && K >= 3 && K <= N, "unsupported board");
+    static constexpr int Words = BoardWords(N);
+    static constexpr int Size() { return N; }
+    static constexpr int WinLength() { return K; }
+};
+
+// any size up to MaxBoardSize chosen at run time, storage still inline
+struct DynamicGeometry
+{
+    static constexpr int Words = BoardWords(MaxBoardSize);
+    int size;
+    int winLength;
+
+    DynamicGeometry(int size = 3, int winLength = 3) : size(size), winLength(winLength) {}
+    int Size() const { return size; }
+    int WinLength() const { return winLength; }
+};
+
+template <typename Geometry>
+class GenericBoard : private Geometry
+{
+public:
+    static constexpr int Words = Geometry::Words;
+    using Bits = std::array<uint64_t, Words>;
+
+    explicit GenericBoard(const Geometry& geometry = Geometry()) : Geometry(geometry) { Reset(); }
+    // the same position under another geometry for the same size, the rows are laid out alike
+    template <typename Other>
+    GenericBoard(const GenericBoard<Other>& other, const Geometry& geometry) : Geometry(geometry)
+    {
+        assert(other.Size() == Size() && other.WinLength() == WinLength());
+        Reset();
+        for (int i = 0; i < BoardWords(Size()); ++i)
+        {
+            pieces[0][i] = other.Pieces(X)[i];
+            pieces[1][i] = other.Pieces(O)[i];
+        }
+        moves = other.MoveCount();
+        key = other.StoneKey();
+    }
+
+    int Size() const { return Geometry::Size(); }
+    int WinLength() const { return Geometry::WinLength(); }
+    int CellCount() const { return Size() * Size(); }
+    const Geometry& GetGeometry() const { return *this; }
+
+    void Reset()
+    {
+        pieces[0].fill(0);
+        pieces[1].fill(0);
+        moves = 0;
+        key = 0;
+    }
+    bool IsLegal(int cell) const { return cell >= 0 && cell < CellCount() && At(cell) == EMPTY; }
+    void MakeMove(int cell, CellValue player)
+    {
+        int bit = Bit(cell);
+        pieces[player - X][bit >> 6] |= uint64_t(1) << (bit & 63);
+        key ^= ZobristStone(player, cell);
+        moves++;
+    }
+    // cell must hold a stone, the key is updated with whichever piece is there
+    void UndoMove(int cell)
+    {
+        assert(At(cell) != EMPTY);
+        int bit = Bit(cell);
+        key ^= ZobristStone(At(cell), cell);
+        uint64_t mask = ~(uint64_t(1) << (bit & 63));
+        pieces[0][bit >> 6] &= mask;
+        pieces[1][bit >> 6] &= mask;
+        moves--;
+    }
+
+    CellValue At(int cell) const
+    {
+        int bit = Bit(cell);
+        if ((pieces[0][bit >> 6] >> (bit & 63)) & 1) return X;
+        if ((pieces[1][bit >> 6] >> (bit & 63)) & 1) return O;
+        return EMPTY;
+    }
+    const Bits& Pieces(CellValue player) const { return pieces[player - X]; }
+    int MoveCount() const { return moves; }
+    // the stones' Zobrist key, and the key of the position with toMove to play
+    uint64_t StoneKey() const { return key; }
+    uint64_t Key(CellValue toMove) const { return key ^ ((toMove == O) ? Zobrist.oToMove : 0); }
+
+    // X, O, TIES or NO_ONE if the game goes on
+    CellValue Winner() const
+    {
+        if (HasLine(pieces[0])) return X;
+        if (HasLine(pieces[1])) return O;
+        if (moves == CellCount()) return TIES;
+        return NO_ONE;
+    }
+
+    bool HasLine(const Bits& mask) const
+    {
+        const int width = Size() + 1;
+        // right, down, down-right, down-left
+        const int directions[4] = {1, width, width + 1, width - 1};
+        for (int direction : directions)
+        {
+            if (HasRun(mask, direction))
+                return true;
+        }
+        return false;
+    }
+
+    int Bit(int cell) const { return cell + cell / Size(); }
+
+    bool operator==(const GenericBoard& other) const { return pieces[0] == other.pieces[0] && pieces[1] == other.pieces[1]; }
+    bool operator!=(const GenericBoard& other) const { return !(*this == other); }
+
+private:
+    // bit i of the result is bit i + shift of mask
+    static Bits ShiftDown(const Bits& mask, int shift)
+    {
+        Bits result;
+        const int words = shift >> 6;
+        const int bits = shift & 63;
+        for (int i = 0; i < Words; ++i)
+        {
+            uint64_t lo = (i + words < Words) ? mask[i + words] : 0;
+            uint64_t hi = (i + words + 1 < Words) ? mask[i + words + 1] : 0;
+            result[i] = bits ? (lo >> bits) | (hi << (64 - bits)) : lo;
+        }
+        return result;
+    }
+
+    // K stones in a row along direction: double the run length with every AND
+    bool HasRun(const Bits& mask, int direction) const
+    {
+        Bits run = mask;
+        int length = 1;
+        const int k = WinLength();
+        while (length < k)
+        {
+            int step = (length * 2 <= k) ? length : k - length;
+            Bits shifted = ShiftDown(run, step * direction);
+            uint64_t any = 0;
+            for (int i = 0; i < Words; ++i)
+            {
+                run[i] &= shifted[i];
+                any |= run[i];
+            }
+            if (any == 0)
+                return false;
+            length += step;
+        }
+        return true;
+    }
+
+    std::array<Bits, 2> pieces;
+    int moves;
+    uint64_t key;
+};
+
+template <int N, int K>
+using FixedBoard = GenericBoard<FixedGeometry<N, K>>;
+using DynamicBoard = GenericBoard<DynamicGeometry>;
+
+// f(geometry) with the compile-time geometry of the common variants, 3x3 and 15x15 five
+// in a row, and with the run-time one otherwise; search code converts its DynamicBoard
+// with GenericBoard<decltype(geometry)>(board, geometry) once and runs on that
+template <typename F>
+auto WithGeometry(const DynamicGeometry& geometry, F&& f)
+{
+    if (geometry.Size() == 3 && geometry.WinLength() == 3)
+        return f(FixedGeometry<3, 3>());
+    if (geometry.Size() == 15 && geometry.WinLength() == 5)
+        return f(FixedGeometry<15, 5>());
+    return f(geometry);
+}
+
+// a 3x3, 3-in-a-row board goes to the 9-bit Board for the solver and the opening book
+template <typename Geometry>
+Board ToSmallBoard(const GenericBoard<Geometry>& board)
+{
+    uint16_t masks[2] = {0, 0};
+    for (int cell = 0; cell < Board::Cells; ++cell)
+    {
+        CellValue value = board.At(cell);
+        if (value != EMPTY)
+            masks[value - X] |= uint16_t(1u << cell);
+    }
+    return Board::FromMasks(masks[0], masks[1]);
+}
+
+template <typename Geometry>
+bool IsClassicBoard(const GenericBoard<Geometry>& board)
+{
+    return board.Size() == 3 && board.WinLength() == 3;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "GameTypes.h"
+#include "WinTracker.h"
+
+// computerMove from old_ver.cpp for any board type: take a winning cell, else block the
+// opponent's winning cell, else the free cell with the most winning lines through it.
+// On the 3x3 board the last rule gives the old BEST_MOVES order: center, corners, edges.
+
+// number of K-cell windows that contain (row, col) on an N x N board
+inline int LinesThrough(int n, int k, int row, int col)
+{
+    const int dr[4] = {0, 1, 1, 1};
+    const int dc[4] = {1, 0, 1, -1};
+    int lines = 0;
+    for (int d = 0; d < 4; ++d)
+    {
+        for (int start = -(k - 1); start <= 0; ++start)
+        {
+            int r0 = row + dr[d] * start, c0 = col + dc[d] * start;
+            int r1 = r0 + dr[d] * (k - 1), c1 = c0 + dc[d] * (k - 1);
+            if (r0 >= 0 && r0 < n && r1 >= 0 && r1 < n && c0 >= 0 && c0 < n && c1 >= 0 && c1 < n)
+                lines++;
+        }
+    }
+    return lines;
+}
+
+// the best free cell once nobody can win on the next move
+template <typename B>
+int PreferredMove(const B& board)
+{
+    int best = -1;
+    int bestLines = -1;
+    for (int move = 0; move < board.CellCount(); ++move)
+    {
+        if (!board.IsLegal(move))
+            continue;
+        int lines = LinesThrough(board.Size(), board.WinLength(), move / board.Size(), move % board.Size());
+        if (lines > bestLines)
+        {
+            best = move;
+            bestLines = lines;
+        }
+    }
+    return best;
+}
+
+template <typename B>
+int HeuristicMove(B board, CellValue player)
+{
+    const int cells = board.CellCount();
+    // if AI can win in next move it choose it, else block the human
+    for (CellValue piece : {player, Opponent(player)})
+    {
+        for (int move = 0; move < cells; ++move)
+        {
+            if (!board.IsLegal(move))
+                continue;
+            board.MakeMove(move, piece);
+            bool found = board.Winner() == piece;
+            board.UndoMove(move);
+            if (found)
+                return move;
+        }
+    }
+    // choose the best cell
+    return PreferredMove(board);
+}
+
+// same moves, but the win and block tests are O(K) line-count lookups in the tracker
+template <typename B>
+int HeuristicMove(const B& board, const WinTracker& tracker, CellValue player)
+{
+    for (CellValue piece : {player, Opponent(player)})
+    {
+        for (int move = 0; move < board.CellCount(); ++move)
+        {
+            if (board.IsLegal(move) && tracker.WouldWin(move, piece))
+                return move;
+        }
+    }
+    return PreferredMove(board);
+}
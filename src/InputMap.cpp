@@ -0,0 +1,21 @@
+#include "InputMap.h"
+
+const FrameInput& InputMapper::Sample()
+{
+    Vector2 mouse = GetMousePosition();
+    // the scene is drawn at the virtual size and stretched to the window
+    float scaleX = (float)virtualWidth / (float)GetScreenWidth();
+    float scaleY = (float)virtualHeight / (float)GetScreenHeight();
+    mouse.x *= scaleX;
+    mouse.y *= scaleY;
+    return Inject(mouse, IsMouseButtonPressed(MOUSE_BUTTON_LEFT), IsMouseButtonReleased(MOUSE_BUTTON_LEFT));
+}
+
+const FrameInput& InputMapper::Inject(Vector2 mouse, bool pressed, bool released)
+{
+    input.mouse = mouse;
+    input.leftPressed = pressed;
+    input.leftReleased = released;
+    input.cell = board.CellAt(mouse.x, mouse.y);
+    return input;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <raylib-cpp.hpp>
+
+// Board geometry in virtual screen coordinates (the 1280x800 layout the UI is drawn in).
+struct CellMapping
+{
+    float originX = 0.0f;
+    float originY = 0.0f;
+    float cellSize = 1.0f;
+    int size = 0;
+
+    // row-major cell under the point, -1 off the board
+    int CellAt(float x, float y) const
+    {
+        float col = (x - originX) / cellSize;
+        float row = (y - originY) / cellSize;
+        if (col < 0.0f || row < 0.0f)
+            return -1;
+        int i = (int)col;
+        int j = (int)row;
+        if (i >= size || j >= size)
+            return -1;
+        return j * size + i;
+    }
+};
+
+// Everything the game reads from the mouse in one frame.
+struct FrameInput
+{
+    Vector2 mouse = {0.0f, 0.0f};  // virtual coordinates
+    bool leftPressed = false;
+    bool leftReleased = false;
+    int cell = -1;  // board cell under the mouse, -1 when off the board
+};
+
+// Samples the mouse once per frame, undoes window scaling and resolves the board cell,
+// so the menu, the legality check and the move itself all read the same result.
+class InputMapper
+{
+public:
+    InputMapper(int virtualWidth, int virtualHeight) : virtualWidth(virtualWidth), virtualHeight(virtualHeight) {}
+
+    void SetBoard(const CellMapping& mapping) { board = mapping; }
+    const CellMapping& Board() const { return board; }
+
+    // reads raylib input, call once at the top of the frame
+    const FrameInput& Sample();
+    // scripted or replayed input: a virtual position and button edges
+    const FrameInput& Inject(Vector2 mouse, bool pressed, bool released);
+    const FrameInput& Current() const { return input; }
+
+private:
+    int virtualWidth;
+    int virtualHeight;
+    CellMapping board;
+    FrameInput input;
+};
@@ -0,0 +1,146 @@
+#include "Log.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+Logger& Logger::Instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : slots(Capacity), enqueuePos(0), dequeuePos(0), written(0), dropped(0), minLevel(LOG_COMPILED_LEVEL), running(true),
+      sleeping(false)
+{
+    for (size_t i = 0; i < Capacity; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    worker = std::thread(&Logger::Run, this);
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running.store(false, std::memory_order_release);
+    }
+    wake.notify_one();
+    worker.join();
+    Drain();
+    fflush(stdout);
+}
+
+void Logger::Write(LogLevel level, const char* format, ...)
+{
+    // claim a slot: its sequence equals our position when it is free
+    size_t position = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;)
+    {
+        slot = &slots[position & (Capacity - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(sequence) - intptr_t(position);
+        if (diff == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+            position = enqueuePos.load(std::memory_order_relaxed);
+    }
+
+    slot->level = uint8_t(level);
+    va_list args;
+    va_start(args, format);
+    vsnprintf(slot->text, TextBytes, format, args);
+    va_end(args);
+    // seq_cst like the worker's sleeping store and Pending load: either the worker sees
+    // this line before it sleeps or this sees it sleeping; only the second case locks
+    slot->sequence.store(position + 1, std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake.notify_one();
+    }
+}
+
+bool Logger::Pending() const
+{
+    size_t position = dequeuePos.load(std::memory_order_relaxed);
+    return slots[position & (Capacity - 1)].sequence.load(std::memory_order_seq_cst) == position + 1;
+}
+
+bool Logger::Pop(Slot*& slot, size_t& position)
+{
+    position = dequeuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        slot = &slots[position & (Capacity - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(sequence) - intptr_t(position + 1);
+        if (diff == 0)
+        {
+            if (dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                return true;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            position = dequeuePos.load(std::memory_order_relaxed);
+    }
+}
+
+void Logger::Release(Slot& slot, size_t position)
+{
+    slot.sequence.store(position + Capacity, std::memory_order_release);
+}
+
+void Logger::Drain()
+{
+    static const char* names[LOGLEVEL_OFF] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+    Slot* slot;
+    size_t position;
+    bool any = false;
+    while (Pop(slot, position))
+    {
+        size_t length = strlen(slot->text);
+        const char* newline = (length > 0 && slot->text[length - 1] == '\n') ? "" : "\n";
+        fprintf(stdout, "%s: %s%s", names[slot->level], slot->text, newline);
+        Release(*slot, position);
+        written.fetch_add(1, std::memory_order_release);
+        any = true;
+    }
+    if (any)
+    {
+        fflush(stdout);
+        std::lock_guard<std::mutex> lock(mutex);
+        drained.notify_all();
+    }
+}
+
+void Logger::Flush()
+{
+    // wait until the writer has passed everything claimed before this call
+    size_t target = enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [&]() { return written.load(std::memory_order_acquire) >= target; });
+}
+
+void Logger::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running.load(std::memory_order_acquire))
+    {
+        lock.unlock();
+        Drain();
+        lock.lock();
+        sleeping.store(true, std::memory_order_seq_cst);
+        wake.wait(lock, [this]() { return !running.load(std::memory_order_acquire) || Pending(); });
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum LogLevel
+{
+    LOGLEVEL_TRACE,
+    LOGLEVEL_DEBUG,
+    LOGLEVEL_INFO,
+    LOGLEVEL_WARN,
+    LOGLEVEL_ERROR,
+    LOGLEVEL_OFF
+};
+
+// Levels below this are compiled out: the call and its arguments disappear.
+// Build with -DLOG_COMPILED_LEVEL=0 to keep the trace and debug lines.
+#ifndef LOG_COMPILED_LEVEL
+#define LOG_COMPILED_LEVEL LOGLEVEL_INFO
+#endif
+
+// Callers format into a slot of a bounded lock-free queue (Vyukov MPMC) and return;
+// a background thread writes the lines to stdout and sleeps while the queue is empty,
+// a line written while it sleeps wakes it. When the queue is full the line is dropped
+// and counted instead of blocking the caller.
+class Logger
+{
+public:
+    static Logger& Instance();
+
+    void SetLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    bool Enabled(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    void Write(LogLevel level, const char* format, ...);
+
+    // writes everything queued so far, then returns
+    void Flush();
+    uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+private:
+    static const size_t Capacity = 1024;  // power of two
+    static const size_t TextBytes = 240;
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        uint8_t level;
+        char text[TextBytes];
+    };
+
+    Logger();
+    bool Pop(Slot*& slot, size_t& position);
+    void Release(Slot& slot, size_t position);
+    bool Pending() const;  // the next slot to read has been written
+    void Drain();
+    void Run();
+
+    std::vector<Slot> slots;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+    alignas(64) std::atomic<uint64_t> written;
+    std::atomic<uint64_t> dropped;
+    std::atomic<int> minLevel;
+    std::atomic<bool> running;
+    std::atomic<bool> sleeping;  // the worker waits on wake, Write has to signal it
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;  // written moved on, for Flush
+    std::thread worker;
+};
+
+#define LOG_AT(level, ...)                                  \
+    do                                                      \
+    {                                                       \
+        if constexpr ((level) >= LOG_COMPILED_LEVEL)        \
+        {                                                   \
+            if (Logger::Instance().Enabled(level))          \
+                Logger::Instance().Write(level, __VA_ARGS__); \
+        }                                                   \
+    } while (0)
+
+#define TRACE_LOG(...) LOG_AT(LOGLEVEL_TRACE, __VA_ARGS__)
+#define DEBUG_LOG(...) LOG_AT(LOGLEVEL_DEBUG, __VA_ARGS__)
+#define INFO_LOG(...) LOG_AT(LOGLEVEL_INFO, __VA_ARGS__)
+#define WARN_LOG(...) LOG_AT(LOGLEVEL_WARN, __VA_ARGS__)
+#define ERROR_LOG(...) LOG_AT(LOGLEVEL_ERROR, __VA_ARGS__)
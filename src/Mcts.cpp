@@ -0,0 +1,384 @@
+#include "Mcts.h"
+#include <cmath>
+
+struct MctsSearch::Worker
+{
+    DynamicBoard board;
+    WinTracker tracker;
+    std::vector<int> path;  // nodes from the root
+    std::vector<int> playout;  // moves after the tree, undone afterwards
+    std::vector<int> empty;
+    uint64_t rng;
+
+    uint32_t Random(uint32_t range)
+    {
+        // xorshift64*, no state shared between threads
+        rng ^= rng >> 12;
+        rng ^= rng << 25;
+        rng ^= rng >> 27;
+        return uint32_t(((rng * 0x2545F4914F6CDD1Dull) >> 32) * range >> 32);
+    }
+};
+
+MctsSearch::MctsSearch(const MctsConfig& config)
+    : capacity(0), used(0), iterations(0), sliceGeneration(0), helpersRunning(0), helpersQuit(false),
+      stopFlag(nullptr), rootPlayer(X), forced(-1), searching(false)
+{
+    SetConfig(config);
+}
+
+MctsSearch::~MctsSearch()
+{
+    StopHelpers();
+}
+
+void MctsSearch::SetConfig(const MctsConfig& newConfig)
+{
+    // the next Begin starts as many helpers as the new config asks for
+    StopHelpers();
+    config = newConfig;
+    if (config.threads < 1)
+        config.threads = 1;
+    if (config.iterations <= 0 && config.timeMs <= 0.0)
+        config.timeMs = 500.0;
+    if (config.maxNodes != capacity)
+    {
+        capacity = config.maxNodes;
+        nodes.reset(new Node[capacity]);
+    }
+    searching = false;
+}
+
+int MctsSearch::BestMove(const DynamicBoard& board, const WinTracker& tracker, CellValue player)
+{
+    Begin(board, tracker, player);
+    // one slice with no time limit of its own: the configured budget ends it
+    while (!Think(1e9))
+        ;
+    return Result();
+}
+
+void MctsSearch::Begin(const DynamicBoard& board, const WinTracker& tracker, CellValue player)
+{
+    while ((int)workers.size() < config.threads)
+        workers.push_back(std::make_unique<Worker>());
+    for (int i = 0; i < config.threads; ++i)
+    {
+        Worker& worker = *workers[i];
+        worker.board = board;
+        worker.tracker = tracker;
+        worker.path.reserve(board.CellCount() + 1);
+        worker.playout.reserve(board.CellCount());
+        worker.empty.reserve(board.CellCount());
+        worker.rng = (config.seed + i + 1) * 0x9E3779B97F4A7C15ull;
+    }
+    StartHelpers();
+
+    rootPlayer = player;
+    stats = MctsStats();
+    iterations.store(0, std::memory_order_relaxed);
+    used.store(1, std::memory_order_relaxed);
+    nodes[0].firstChild.store(-1, std::memory_order_relaxed);
+    nodes[0].childCount = 0;
+    nodes[0].move = -1;
+    nodes[0].visits.store(0, std::memory_order_relaxed);
+    nodes[0].score.store(0, std::memory_order_relaxed);
+
+    // a win now or the only block needs no search
+    forced = -1;
+    searching = tracker.Result() == NO_ONE;
+    for (CellValue piece : {player, Opponent(player)})
+    {
+        for (int cell = 0; searching && forced < 0 && cell < board.CellCount(); ++cell)
+        {
+            if (board.IsLegal(cell) && tracker.WouldWin(cell, piece))
+                forced = cell;
+        }
+    }
+    if (forced >= 0)
+        searching = false;
+}
+
+bool MctsSearch::BudgetSpent() const
+{
+    if (config.iterations > 0 && iterations.load(std::memory_order_relaxed) >= uint64_t(config.iterations))
+        return true;
+    return config.timeMs > 0.0 && stats.elapsedMs >= config.timeMs;
+}
+
+bool MctsSearch::Think(double sliceMs)
+{
+    if (!searching)
+        return true;
+    Clock::time_point start = Clock::now();
+    double remaining = (config.timeMs > 0.0) ? config.timeMs - stats.elapsedMs : sliceMs;
+    double budget = (sliceMs < remaining) ? sliceMs : remaining;
+    Clock::time_point deadline = start + std::chrono::microseconds(int64_t(budget * 1000.0));
+
+    if (!helpers.empty())
+    {
+        std::lock_guard<std::mutex> lock(sliceMutex);
+        sliceDeadline = deadline;
+        sliceGeneration++;
+        helpersRunning = int(helpers.size());
+    }
+    sliceStart.notify_all();
+    Run(*workers[0], deadline);
+    if (!helpers.empty())
+    {
+        std::unique_lock<std::mutex> lock(sliceMutex);
+        sliceDone.wait(lock, [this]() { return helpersRunning == 0; });
+    }
+
+    stats.elapsedMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    stats.iterations = iterations.load(std::memory_order_relaxed);
+    int nodeCount = used.load(std::memory_order_relaxed);
+    stats.nodes = (nodeCount < capacity) ? nodeCount : capacity;
+    bool stopped = stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed);
+    if (stopped || BudgetSpent() || nodes[0].firstChild.load(std::memory_order_acquire) < 0)
+        searching = false;
+    return !searching;
+}
+
+void MctsSearch::StartHelpers()
+{
+    if (!helpers.empty() || config.threads == 1)
+        return;
+    helpersQuit = false;
+    for (int i = 1; i < config.threads; ++i)
+        helpers.emplace_back(&MctsSearch::HelperLoop, this, i, sliceGeneration);
+}
+
+void MctsSearch::StopHelpers()
+{
+    {
+        std::lock_guard<std::mutex> lock(sliceMutex);
+        helpersQuit = true;
+    }
+    sliceStart.notify_all();
+    for (std::thread& thread : helpers)
+        thread.join();
+    helpers.clear();
+}
+
+void MctsSearch::HelperLoop(int index, uint64_t seen)
+{
+    std::unique_lock<std::mutex> lock(sliceMutex);
+    for (;;)
+    {
+        sliceStart.wait(lock, [&]() { return helpersQuit || sliceGeneration != seen; });
+        if (helpersQuit)
+            return;
+        seen = sliceGeneration;
+        Clock::time_point deadline = sliceDeadline;
+        lock.unlock();
+        Run(*workers[index], deadline);
+        lock.lock();
+        if (--helpersRunning == 0)
+            sliceDone.notify_one();
+    }
+}
+
+int MctsSearch::Result() const
+{
+    if (forced >= 0)
+        return forced;
+    int first = nodes[0].firstChild.load(std::memory_order_acquire);
+    if (first < 0)
+        return -1;
+    int best = -1;
+    int bestVisits = -1;
+    for (int i = first; i < first + nodes[0].childCount; ++i)
+    {
+        int visits = nodes[i].visits.load(std::memory_order_relaxed);
+        if (visits > bestVisits)
+        {
+            best = nodes[i].move;
+            bestVisits = visits;
+        }
+    }
+    return best;
+}
+
+void MctsSearch::Run(Worker& worker, Clock::time_point deadline)
+{
+    WithGeometry(worker.board.GetGeometry(), [&](auto geometry) {
+        GenericBoard<decltype(geometry)> board(worker.board, geometry);
+        RunOn(worker, board, deadline);
+    });
+}
+
+template <typename B>
+void MctsSearch::RunOn(Worker& worker, B& board, Clock::time_point deadline)
+{
+    // iterations are claimed in batches: the shared counter and the clock are touched
+    // once per batch, a playout is far shorter than a frame
+    const uint64_t Batch = 16;
+    const uint64_t limit = (config.iterations > 0) ? uint64_t(config.iterations) : UINT64_MAX;
+    for (;;)
+    {
+        uint64_t start = iterations.fetch_add(Batch, std::memory_order_relaxed);
+        if (start >= limit)
+        {
+            iterations.fetch_sub(Batch, std::memory_order_relaxed);
+            return;
+        }
+        uint64_t count = (limit - start < Batch) ? limit - start : Batch;
+        if (count < Batch)
+            iterations.fetch_sub(Batch - count, std::memory_order_relaxed);
+        for (uint64_t i = 0; i < count; ++i)
+            Iterate(worker, board);
+        if (Clock::now() >= deadline || (stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed)))
+            return;
+    }
+}
+
+template <typename B>
+bool MctsSearch::Expand(int node, const B& board)
+{
+    int32_t expected = -1;
+    if (!nodes[node].firstChild.compare_exchange_strong(expected, -2, std::memory_order_acq_rel))
+        return false;
+
+    // candidates: free cells within two of a stone, the center on an empty board
+    const int size = board.Size();
+    int count = 0;
+    int moves[MaxBoardSize * MaxBoardSize];
+    if (board.MoveCount() == 0)
+        moves[count++] = (size / 2) * size + size / 2;
+    for (int cell = 0; board.MoveCount() > 0 && cell < board.CellCount(); ++cell)
+    {
+        if (!board.IsLegal(cell))
+            continue;
+        int row = cell / size, col = cell % size;
+        bool near = false;
+        for (int r = row - 2; !near && r <= row + 2; ++r)
+        {
+            for (int c = col - 2; !near && c <= col + 2; ++c)
+                near = r >= 0 && r < size && c >= 0 && c < size && board.At(r * size + c) != EMPTY;
+        }
+        if (near)
+            moves[count++] = cell;
+    }
+
+    int first = used.fetch_add(count, std::memory_order_relaxed);
+    if (count == 0 || first + count > capacity)
+    {
+        // pool used up: stays a leaf for good
+        nodes[node].firstChild.store(-2, std::memory_order_release);
+        return false;
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        Node& child = nodes[first + i];
+        child.firstChild.store(-1, std::memory_order_relaxed);
+        child.childCount = 0;
+        child.move = int16_t(moves[i]);
+        child.visits.store(0, std::memory_order_relaxed);
+        child.score.store(0, std::memory_order_relaxed);
+    }
+    nodes[node].childCount = int16_t(count);
+    nodes[node].firstChild.store(first, std::memory_order_release);
+    return true;
+}
+
+int MctsSearch::Select(int node) const
+{
+    const Node& parent = nodes[node];
+    int first = parent.firstChild.load(std::memory_order_acquire);
+    float logVisits = std::log(float(parent.visits.load(std::memory_order_relaxed)) + 1.0f);
+    int best = first;
+    float bestValue = -1.0f;
+    for (int i = first; i < first + parent.childCount; ++i)
+    {
+        int visits = nodes[i].visits.load(std::memory_order_relaxed);
+        if (visits == 0)
+            return i;
+        float mean = float(nodes[i].score.load(std::memory_order_relaxed)) / (2.0f * float(visits));
+        float value = mean + config.exploration * std::sqrt(logVisits / float(visits));
+        if (value > bestValue)
+        {
+            best = i;
+            bestValue = value;
+        }
+    }
+    return best;
+}
+
+template <typename B>
+CellValue MctsSearch::Playout(Worker& worker, const B& board, CellValue toMove)
+{
+    worker.empty.clear();
+    for (int cell = 0; cell < board.CellCount(); ++cell)
+    {
+        if (board.IsLegal(cell))
+            worker.empty.push_back(cell);
+    }
+    // random moves on the tracker only, the same result rules as checkWinner
+    CellValue result = NO_ONE;
+    while (result == NO_ONE && !worker.empty.empty())
+    {
+        uint32_t pick = worker.Random(uint32_t(worker.empty.size()));
+        int cell = worker.empty[pick];
+        worker.empty[pick] = worker.empty.back();
+        worker.empty.pop_back();
+        worker.tracker.MakeMove(cell, toMove);
+        worker.playout.push_back(cell);
+        result = worker.tracker.Result();
+        toMove = Opponent(toMove);
+    }
+    for (int i = int(worker.playout.size()) - 1; i >= 0; --i)
+    {
+        toMove = Opponent(toMove);
+        worker.tracker.UndoMove(worker.playout[i], toMove);
+    }
+    worker.playout.clear();
+    return result;
+}
+
+template <typename B>
+void MctsSearch::Iterate(Worker& worker, B& board)
+{
+    worker.path.clear();
+    worker.path.push_back(0);
+    nodes[0].visits.fetch_add(1, std::memory_order_relaxed);
+
+    int node = 0;
+    CellValue toMove = rootPlayer;
+    CellValue result = NO_ONE;
+    while (result == NO_ONE)
+    {
+        Node& current = nodes[node];
+        int first = current.firstChild.load(std::memory_order_acquire);
+        if (first < 0)
+        {
+            bool ready = node == 0 || current.visits.load(std::memory_order_relaxed) > config.expandVisits;
+            if (first != -1 || !ready || !Expand(node, board))
+                break;
+        }
+        int child = Select(node);
+        // virtual loss: the visit counts now, its score only after the playout
+        nodes[child].visits.fetch_add(1, std::memory_order_relaxed);
+        worker.path.push_back(child);
+        int move = nodes[child].move;
+        board.MakeMove(move, toMove);
+        worker.tracker.MakeMove(move, toMove);
+        result = worker.tracker.Result();
+        toMove = Opponent(toMove);
+        node = child;
+    }
+    if (result == NO_ONE)
+        result = Playout(worker, board, toMove);
+
+    // the node at depth d was entered by the root player when d is odd
+    for (size_t depth = worker.path.size() - 1; depth > 0; --depth)
+    {
+        CellValue mover = (depth % 2 == 1) ? rootPlayer : Opponent(rootPlayer);
+        int points = (result == mover) ? 2 : (result == TIES) ? 1 : 0;
+        Node& entered = nodes[worker.path[depth]];
+        if (points > 0)
+            entered.score.fetch_add(points, std::memory_order_relaxed);
+        board.UndoMove(entered.move);
+        worker.tracker.UndoMove(entered.move, mover);
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GameTypes.h"
+#include "GenericBoard.h"
+#include "WinTracker.h"
+
+struct MctsConfig
+{
+    int iterations = 0;  // 0: limited by time only
+    double timeMs = 500.0;  // total thinking time per move, 0: limited by iterations only
+    int threads = 1;
+    int maxNodes = 1 << 20;  // node pool, the tree stops growing when it is used up
+    float exploration = 1.4f;
+    int expandVisits = 2;  // visits before a leaf gets children
+    uint64_t seed = 1;
+};
+
+struct MctsStats
+{
+    uint64_t iterations = 0;
+    int nodes = 0;
+    double elapsedMs = 0.0;
+};
+
+// Monte Carlo tree search for any board size.
+// Tree parallel: all threads share one tree, a thread going down a node adds a visit
+// before its result is known (virtual loss), which spreads the threads over different lines.
+// Nodes come from a pool allocated once; playouts make and undo moves on per-thread
+// copies of the board and tracker, so iterations don't allocate.
+// Begin + Think(slice) lets a caller spread one search over several frames; the helper
+// threads are started by the first Begin and wait between slices for the next deadline.
+class MctsSearch
+{
+public:
+    explicit MctsSearch(const MctsConfig& config = MctsConfig());
+    ~MctsSearch();
+
+    void SetConfig(const MctsConfig& config);
+    const MctsConfig& Config() const { return config; }
+    // searches end early while *flag is true, e.g. when the player cancels the move
+    void SetStopFlag(const std::atomic<bool>* flag) { stopFlag = flag; }
+
+    // blocking search with the whole budget
+    int BestMove(const DynamicBoard& board, const WinTracker& tracker, CellValue player);
+
+    // starts a search from this position; an immediate win or a forced block skips it
+    void Begin(const DynamicBoard& board, const WinTracker& tracker, CellValue player);
+    // searches for at most sliceMs, true once the budget is spent and Result() is final
+    bool Think(double sliceMs);
+    // the most visited root move so far, -1 before Begin or on a full board
+    int Result() const;
+    const MctsStats& Stats() const { return stats; }
+
+private:
+    struct Node
+    {
+        // -1 leaf, -2 being expanded by some thread, otherwise index of the first child
+        std::atomic<int32_t> firstChild;
+        int16_t childCount;
+        int16_t move;
+        std::atomic<int32_t> visits;
+        std::atomic<int32_t> score;  // half points for the player who made move: win 2, draw 1
+    };
+    struct Worker;
+    using Clock = std::chrono::steady_clock;
+
+    // the iterations run on board, the worker's position under its compile-time geometry
+    // when the size has one (see WithGeometry)
+    void Run(Worker& worker, Clock::time_point deadline);
+    template <typename B>
+    void RunOn(Worker& worker, B& board, Clock::time_point deadline);
+    template <typename B>
+    void Iterate(Worker& worker, B& board);
+    template <typename B>
+    bool Expand(int node, const B& board);
+    int Select(int node) const;
+    template <typename B>
+    CellValue Playout(Worker& worker, const B& board, CellValue toMove);
+    bool BudgetSpent() const;
+    void StartHelpers();
+    void StopHelpers();
+    // runs workers[index] for every slice after generation seen until StopHelpers
+    void HelperLoop(int index, uint64_t seen);
+
+    MctsConfig config;
+    std::unique_ptr<Node[]> nodes;
+    int capacity;
+    std::atomic<int32_t> used;
+    std::atomic<uint64_t> iterations;
+    std::vector<std::unique_ptr<Worker>> workers;
+    // a new slice bumps the generation under the mutex, the last helper done signals sliceDone
+    std::vector<std::thread> helpers;
+    std::mutex sliceMutex;
+    std::condition_variable sliceStart;
+    std::condition_variable sliceDone;
+    uint64_t sliceGeneration;
+    Clock::time_point sliceDeadline;
+    int helpersRunning;
+    bool helpersQuit;
+    const std::atomic<bool>* stopFlag;
+    CellValue rootPlayer;
+    int forced;
+    bool searching;
+    MctsStats stats;
+};
@@ -0,0 +1,154 @@
+#include "OpeningBook.h"
+#include <cstdio>
+
+namespace
+{
+bool WriteU32(FILE* file, uint32_t value)
+{
+    uint8_t bytes[4] = {uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)};
+    return fwrite(bytes, 1, 4, file) == 4;
+}
+
+bool ReadU32(FILE* file, uint32_t& value)
+{
+    uint8_t bytes[4];
+    if (fread(bytes, 1, 4, file) != 4)
+        return false;
+    value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t(bytes[3]) << 24);
+    return true;
+}
+}  // namespace
+
+OpeningBook::OpeningBook()
+    : slots(size_t(1) << SlotBits, 0), solved(0), loaded(false)
+{
+}
+
+const uint32_t* OpeningBook::Find(int index) const
+{
+    const uint32_t mask = uint32_t(slots.size() - 1);
+    for (uint32_t i = Home(index);; i = (i + 1) & mask)
+    {
+        if (slots[i] == 0)
+            return nullptr;
+        if ((slots[i] >> 8) == uint32_t(index) + 1)
+            return &slots[i];
+    }
+}
+
+void OpeningBook::Insert(int index, uint8_t entry)
+{
+    const uint32_t mask = uint32_t(slots.size() - 1);
+    uint32_t i = Home(index);
+    while (slots[i] != 0)
+        i = (i + 1) & mask;
+    slots[i] = ((uint32_t(index) + 1) << 8) | entry;
+    solved++;
+}
+
+void OpeningBook::Generate(Solver& solver)
+{
+    slots.assign(slots.size(), 0);
+    solved = 0;
+    Board board;
+    Solve(board, X, solver);
+    loaded = true;
+}
+
+void OpeningBook::Solve(Board& board, CellValue player, Solver& solver)
+{
+    int transform;
+    int index = Index(board, player, transform);
+    if (Find(index) != nullptr)
+        return;
+
+    BookOutcome outcome;
+    int move = solver.BestMove(board, player);
+    if (move < 0)
+    {
+        // decided positions: the side to move has either lost or drawn
+        outcome = (board.Winner() == TIES) ? BOOK_DRAW : BOOK_LOSS;
+    }
+    else
+    {
+        int score = solver.Evaluate(board, player);
+        outcome = (score > 0) ? BOOK_WIN : (score < 0) ? BOOK_LOSS
+                                                       : BOOK_DRAW;
+    }
+    Insert(index, uint8_t((move < 0 ? 0xF : Symmetry::MapCell(transform, move)) | (outcome << 4)));
+
+    for (int cell = 0; cell < Board::Cells && move >= 0; ++cell)
+    {
+        if (!board.IsLegal(cell))
+            continue;
+        board.MakeMove(cell, player);
+        Solve(board, Opponent(player), solver);
+        board.UndoMove(cell);
+    }
+}
+
+bool OpeningBook::Save(const char* path) const
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+    bool ok = WriteU32(file, Magic) && WriteU32(file, Version) && WriteU32(file, uint32_t(solved));
+    for (uint32_t slot : slots)
+    {
+        if (slot == 0)
+            continue;
+        uint32_t index = (slot >> 8) - 1;
+        uint8_t record[3] = {uint8_t(index), uint8_t(index >> 8), uint8_t(slot)};
+        ok = ok && fwrite(record, 1, 3, file) == 3;
+    }
+    return (fclose(file) == 0) && ok;
+}
+
+bool OpeningBook::Load(const char* path)
+{
+    // a failed load leaves an empty book, never half of this file or what an earlier load left
+    slots.assign(slots.size(), 0);
+    solved = 0;
+    loaded = false;
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+        return false;
+    uint32_t magic = 0, version = 0, count = 0;
+    bool ok = ReadU32(file, magic) && ReadU32(file, version) && ReadU32(file, count) &&
+              magic == Magic && version == Version && count < slots.size();
+    std::vector<uint8_t> data(ok ? count * 3 : 0);
+    ok = ok && fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    if (!ok)
+        return false;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        int index = data[i * 3] | (data[i * 3 + 1] << 8);
+        uint8_t entry = data[i * 3 + 2];
+        // a move Probe can't map back or an outcome outside BookOutcome means the file isn't ours
+        int move = entry & 0xF;
+        bool valid = (move < Board::Cells || move == 0xF) && (entry >> 4) <= BOOK_UNKNOWN;
+        if (index >= Positions || !valid || Find(index) != nullptr)
+        {
+            slots.assign(slots.size(), 0);
+            solved = 0;
+            return false;
+        }
+        Insert(index, entry);
+    }
+    loaded = true;
+    return true;
+}
+
+bool OpeningBook::Probe(const Board& board, CellValue player, BookEntry& entry) const
+{
+    int transform;
+    const uint32_t* slot = Find(Index(board, player, transform));
+    if (slot == nullptr)
+        return false;
+    int move = *slot & 0xF;
+    entry.move = (move == 0xF) ? -1 : Symmetry::UnmapCell(transform, move);
+    entry.outcome = BookOutcome((*slot >> 4) & 0xF);
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+#include "Solver.h"
+#include "Symmetry.h"
+
+enum BookOutcome
+{
+    BOOK_DRAW,
+    BOOK_WIN,
+    BOOK_LOSS,
+    BOOK_UNKNOWN
+};
+
+struct BookEntry
+{
+    int move;  // -1 when the position is already decided
+    BookOutcome outcome;  // from the side to move
+};
+
+// Every position reachable from the empty board, solved once.
+// Positions are stored from the side to move ("mine"/"theirs"), so one table serves
+// games where either X or O moved first, and only in canonical (symmetry-reduced) form.
+// A position is the base-3 number of its canonical cells, its entry is one byte:
+// best move (a canonical cell) in the low nibble, outcome above it.
+// In memory the entries sit in a small open-addressed table, one probe in the common case.
+class OpeningBook
+{
+public:
+    static constexpr uint32_t Magic = 0x42545454;  // "TTTB"
+    static constexpr uint16_t Version = 2;
+    static constexpr int Positions = 19683;  // 3^9
+    static constexpr int SlotBits = 11;
+
+    OpeningBook();
+
+    void Generate(Solver& solver);
+    // false on a missing or invalid file, the book is empty then
+    bool Load(const char* path);
+    bool Save(const char* path) const;
+
+    bool IsLoaded() const { return loaded; }
+    int Size() const { return solved; }
+    bool Probe(const Board& board, CellValue player, BookEntry& entry) const;
+
+private:
+    static int Index(const Board& board, CellValue player, int& transform)
+    {
+        Symmetry::Canonical canonical = Symmetry::Canonicalize(board.Pieces(player), board.Pieces(Opponent(player)));
+        transform = canonical.transform;
+        return Pow3Index[canonical.first] + 2 * Pow3Index[canonical.second];
+    }
+    static uint32_t Home(int index) { return (uint32_t(index) * 0x9E3779B1u) >> (32 - SlotBits); }
+    const uint32_t* Find(int index) const;
+    void Insert(int index, uint8_t entry);
+    void Solve(Board& board, CellValue player, Solver& solver);
+
+    static const std::array<uint16_t, Board::FullMask + 1> Pow3Index;
+
+    // (index + 1) << 8 | entry, 0 marks a free slot
+    std::vector<uint32_t> slots;
+    int solved;
+    bool loaded;
+};
+
+// Pow3Index[mask] is the sum of 3^cell over the cells set in mask
+constexpr std::array<uint16_t, Board::FullMask + 1> BuildPow3Index()
+{
+    std::array<uint16_t, Board::FullMask + 1> index = {};
+    for (unsigned mask = 0; mask <= Board::FullMask; ++mask)
+    {
+        unsigned weight = 1;
+        for (int cell = 0; cell < Board::Cells; ++cell)
+        {
+            if ((mask >> cell) & 1)
+                index[mask] += uint16_t(weight);
+            weight *= 3;
+        }
+    }
+    return index;
+}
+inline constexpr std::array<uint16_t, Board::FullMask + 1> OpeningBook::Pow3Index = BuildPow3Index();
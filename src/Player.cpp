@@ -0,0 +1,42 @@
+#include "Player.h"
+#include "Heuristic.h"
+
+int AIPlayer::AIMove(const DynamicBoard& board, const WinTracker& tracker)
+{
+    if (strategy == AI_MCTS)
+        return Mcts().BestMove(board, tracker, getPiece());
+    if (strategy == AI_DEEPENING)
+        return deepening.BestMove(board, tracker, getPiece());
+
+    // exact play on the classic board, the old heuristic on the larger variants
+    if (!IsClassicBoard(board))
+    {
+        return WithGeometry(board.GetGeometry(), [&](auto geometry) {
+            return HeuristicMove(GenericBoard<decltype(geometry)>(board, geometry), tracker, getPiece());
+        });
+    }
+
+    Board classic = ToSmallBoard(board);
+    BookEntry entry;
+    // a stale or foreign book could name a taken cell, the solver has the final word then
+    if (book != nullptr && book->Probe(classic, getPiece(), entry) && classic.IsLegal(entry.move))
+        return entry.move;
+    return solver.BestMove(classic, getPiece());
+}
+
+void AIPlayer::SetMctsConfig(const MctsConfig& config)
+{
+    mctsConfig = config;
+    if (mcts)
+        mcts->SetConfig(config);
+}
+
+MctsSearch& AIPlayer::Mcts()
+{
+    if (!mcts)
+    {
+        mcts = std::make_unique<MctsSearch>(mctsConfig);
+        mcts->SetStopFlag(&stop);
+    }
+    return *mcts;
+}
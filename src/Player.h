@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "GameTypes.h"
+#include "GenericBoard.h"
+#include "Deepening.h"
+#include "Mcts.h"
+#include "OpeningBook.h"
+#include "Solver.h"
+#include "WinTracker.h"
+
+// The piece a seat plays. Players aren't polymorphic: how a move is chosen is a move
+// provider (see Strategy.h), something with NextMove(board, tracker) returning -1 when it
+// has no move yet, so game loops can be templates over the two sides.
+class Player
+{
+    CellValue piece;
+
+public:
+    void setPiece(CellValue p) { piece = p; };
+    CellValue getPiece() const { return piece; };
+};
+
+// moves come from the UI: the clicked cell is handed out once, if it is legal
+class HumanPlayer : public Player
+{
+public:
+    void Submit(int cell) { pending = cell; }
+    int NextMove(const DynamicBoard& board, const WinTracker&)
+    {
+        int cell = pending;
+        pending = -1;
+        return board.IsLegal(cell) ? cell : -1;
+    }
+
+private:
+    int pending = -1;
+};
+
+// AI_AUTO: book and solver on 3x3, the heuristic on larger boards; AI_MCTS: tree search on any board;
+// AI_DEEPENING: iterative deepening alpha-beta on any board
+enum AIStrategy
+{
+    AI_AUTO,
+    AI_MCTS,
+    AI_DEEPENING
+};
+
+class AIPlayer : public Player
+{
+public:
+    AIPlayer() { deepening.SetStopFlag(&stop); }
+
+    // cell to play for this player's piece, -1 if the game is over
+    int AIMove(const DynamicBoard& board, const WinTracker& tracker);
+    int NextMove(const DynamicBoard& board, const WinTracker& tracker) { return AIMove(board, tracker); }
+    // safe from another thread: a running search returns its best move so far soon after
+    void RequestStop() { stop.store(true, std::memory_order_relaxed); }
+    void ClearStop() { stop.store(false, std::memory_order_relaxed); }
+
+    void SetBook(const OpeningBook* b) { book = b; }
+    void SetStrategy(AIStrategy s) { strategy = s; }
+    AIStrategy GetStrategy() const { return strategy; }
+    void SetMctsConfig(const MctsConfig& config);
+    const SolverStats& GetStats() const { return solver.Stats(); }
+    // MCTS search of the last move, empty before the first one
+    MctsStats GetMctsStats() const { return mcts ? mcts->Stats() : MctsStats(); }
+    void SetDeepeningConfig(const DeepeningConfig& config) { deepening.SetConfig(config); }
+    // completed depths of the last iterative deepening move
+    const std::vector<DepthStats>& GetDepthStats() const { return deepening.Stats(); }
+    const TTCounters& GetTableStats() const { return deepening.TableStats(); }
+
+private:
+    MctsSearch& Mcts();
+
+    Solver solver;
+    const OpeningBook* book = nullptr;
+    AIStrategy strategy = AI_AUTO;
+    MctsConfig mctsConfig;
+    std::unique_ptr<MctsSearch> mcts;  // created on first use, the node pool is large
+    DeepeningSearch deepening;
+    std::atomic<bool> stop{false};
+};
@@ -0,0 +1,131 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <raylib-cpp.hpp>
+
+FrameProfiler::FrameProfiler(int capacity)
+    : epoch(std::chrono::steady_clock::now()), frames(capacity), head(0), count(0), enabled(false), inFrame(false),
+      scratch(capacity), framesSinceStats(0)
+{
+    std::fill(openPhase, openPhase + PHASE_COUNT, 0);
+    for (auto& row : stats)
+        row[0] = row[1] = 0;
+}
+
+const char* FrameProfiler::PhaseName(ProfilePhase phase)
+{
+    static const char* names[PHASE_COUNT + 1] = {"input", "update", "ai think", "draw", "present", "frame"};
+    return names[phase];
+}
+
+void FrameProfiler::BeginFrame()
+{
+    if (!enabled)
+        return;
+    Frame& frame = frames[head];
+    frame.start = Now();
+    frame.duration = 0;
+    std::fill(frame.phaseStart, frame.phaseStart + PHASE_COUNT, 0);
+    std::fill(frame.phaseDuration, frame.phaseDuration + PHASE_COUNT, 0);
+    inFrame = true;
+}
+
+void FrameProfiler::EndFrame()
+{
+    if (!enabled || !inFrame)
+        return;
+    Frame& frame = frames[head];
+    frame.duration = Now() - frame.start;
+    head = (head + 1) % int(frames.size());
+    count = std::min(count + 1, int(frames.size()));
+    inFrame = false;
+    framesSinceStats++;
+}
+
+void FrameProfiler::BeginPhase(ProfilePhase phase)
+{
+    if (!enabled || !inFrame)
+        return;
+    openPhase[phase] = Now();
+}
+
+void FrameProfiler::EndPhase(ProfilePhase phase)
+{
+    if (!enabled || !inFrame)
+        return;
+    Frame& frame = frames[head];
+    uint64_t end = Now();
+    // a phase entered twice in one frame keeps its first start and the summed time
+    if (frame.phaseDuration[phase] == 0)
+        frame.phaseStart[phase] = openPhase[phase] - frame.start;
+    frame.phaseDuration[phase] += end - openPhase[phase];
+}
+
+double FrameProfiler::Percentile(ProfilePhase phase, double p) const
+{
+    if (count == 0)
+        return 0.0;
+    std::vector<uint64_t> values(count);
+    for (int i = 0; i < count; ++i)
+        values[i] = (phase == PHASE_COUNT) ? frames[i].duration : frames[i].phaseDuration[phase];
+    size_t rank = std::min(values.size() - 1, size_t(p / 100.0 * values.size()));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank] / 1e6;
+}
+
+void FrameProfiler::DrawOverlay(int x, int y)
+{
+    if (!enabled)
+        return;
+    if (framesSinceStats >= 30 || stats[PHASE_COUNT][0] == 0)
+    {
+        // percentiles on the reusable scratch buffer, not every frame
+        for (int phase = 0; phase <= PHASE_COUNT; ++phase)
+        {
+            for (int i = 0; i < count; ++i)
+                scratch[i] = (phase == PHASE_COUNT) ? frames[i].duration : frames[i].phaseDuration[phase];
+            for (int k = 0; k < 2 && count > 0; ++k)
+            {
+                size_t rank = std::min(size_t(count - 1), size_t((k == 0 ? 0.50 : 0.99) * count));
+                std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.begin() + count);
+                stats[phase][k] = scratch[rank] / 1e6;
+            }
+        }
+        framesSinceStats = 0;
+    }
+
+    DrawRectangle(x, y, 250, 20 + 18 * (PHASE_COUNT + 1), Color{0, 0, 0, 160});
+    DrawText("p50 / p99 ms", x + 8, y + 4, 16, RAYWHITE);
+    for (int phase = 0; phase <= PHASE_COUNT; ++phase)
+    {
+        DrawText(TextFormat("%-8s %6.2f / %6.2f", PhaseName(ProfilePhase(phase)), stats[phase][0], stats[phase][1]),
+                 x + 8, y + 22 + 18 * phase, 16, (phase == PHASE_COUNT) ? YELLOW : RAYWHITE);
+    }
+}
+
+bool FrameProfiler::WriteChromeTrace(const char* path) const
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+        return false;
+    fprintf(file, "{\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main loop\"}}");
+    // oldest frame first
+    int first = (count < int(frames.size())) ? 0 : head;
+    for (int i = 0; i < count; ++i)
+    {
+        const Frame& frame = frames[(first + i) % frames.size()];
+        fprintf(file, ",\n{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                frame.start / 1e3, frame.duration / 1e3);
+        for (int phase = 0; phase < PHASE_COUNT; ++phase)
+        {
+            if (frame.phaseDuration[phase] == 0)
+                continue;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                    PhaseName(ProfilePhase(phase)), (frame.start + frame.phaseStart[phase]) / 1e3,
+                    frame.phaseDuration[phase] / 1e3);
+        }
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    return fclose(file) == 0;
+}
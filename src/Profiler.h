@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+enum ProfilePhase
+{
+    PHASE_INPUT,
+    PHASE_UPDATE,
+    PHASE_AI,
+    PHASE_DRAW,
+    PHASE_PRESENT,  // EndDrawing: buffer swap, frame limiter wait and event polling, untimed while it waits for input
+    PHASE_COUNT
+};
+
+// Per-frame phase timings kept in a fixed ring buffer (no allocation after construction).
+// When disabled every call is a single branch.
+class FrameProfiler
+{
+public:
+    explicit FrameProfiler(int capacity = 1024);
+
+    void SetEnabled(bool on) { enabled = on; }
+    bool IsEnabled() const { return enabled; }
+
+    void BeginFrame();
+    void EndFrame();
+    void BeginPhase(ProfilePhase phase);
+    void EndPhase(ProfilePhase phase);
+
+    // milliseconds over the recorded frames, phase == PHASE_COUNT for whole frames
+    double Percentile(ProfilePhase phase, double p) const;
+    int FrameCount() const { return count; }
+
+    // p50/p99 of frames and phases in the top left corner, refreshed every 30 frames
+    void DrawOverlay(int x, int y);
+    // trace events for chrome://tracing and Perfetto
+    bool WriteChromeTrace(const char* path) const;
+
+    static const char* PhaseName(ProfilePhase phase);
+
+private:
+    struct Frame
+    {
+        uint64_t start;  // ns since the profiler was created
+        uint64_t duration;  // ns, 64 bits: a frame that waited for input can take seconds
+        uint64_t phaseStart[PHASE_COUNT];  // ns since frame start
+        uint64_t phaseDuration[PHASE_COUNT];
+    };
+
+    uint64_t Now() const
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    std::chrono::steady_clock::time_point epoch;
+    std::vector<Frame> frames;
+    int head;  // next frame to write
+    int count;
+    bool enabled;
+    bool inFrame;
+    uint64_t openPhase[PHASE_COUNT];
+
+    // overlay cache
+    std::vector<uint64_t> scratch;
+    int framesSinceStats;
+    double stats[PHASE_COUNT + 1][2];
+};
@@ -0,0 +1,85 @@
+#include "Replay.h"
+
+Replay::Replay(int snapshotInterval)
+    : interval(snapshotInterval > 0 ? snapshotInterval : 1), size(3), winLength(3), first(X), recorded(NO_ONE),
+      finalResult(NO_ONE), finalState(MAINMENU), position(0)
+{
+}
+
+bool Replay::Load(const RecordView& record)
+{
+    if (record.size != size || record.winLength != winLength)
+    {
+        size = record.size;
+        winLength = record.winLength;
+        session = GameSession(size, winLength);
+        snapshots.clear();
+    }
+    first = record.first;
+    recorded = record.result;
+    moves.resize(record.moveCount);
+    for (int i = 0; i < record.moveCount; ++i)
+        moves[i] = record.Move(i);
+
+    // one pass to validate the moves and take the snapshots
+    session.Reset();
+    session.Start(first);
+    int count = 0;
+    bool legal = true;
+    for (int i = 0; i <= Length(); ++i)
+    {
+        if (i % interval == 0)
+        {
+            if (count < (int)snapshots.size())
+                snapshots[count] = session;
+            else
+                snapshots.push_back(session);
+            count++;
+        }
+        if (i < Length() && !session.PlayMove(moves[i]))
+        {
+            legal = false;
+            break;
+        }
+    }
+    finalResult = session.Result();
+    finalState = session.State();
+    if (!legal)
+        moves.clear();
+    snapshots.resize(count);
+    session = snapshots[0];
+    position = 0;
+    return legal;
+}
+
+void Replay::Seek(int move)
+{
+    move = (move < 0) ? 0 : (move > Length()) ? Length() : move;
+    if (move < position || move / interval > position / interval)
+    {
+        session = snapshots[move / interval];
+        position = (move / interval) * interval;
+    }
+    while (position < move)
+        Step();
+}
+
+bool Replay::Step()
+{
+    if (AtEnd())
+        return false;
+    session.PlayMove(moves[position]);
+    position++;
+    return true;
+}
+
+bool Replay::Matches() const
+{
+    if (finalResult != recorded)
+        return false;
+    // an unfinished game is still waiting for a move
+    if (recorded == NO_ONE)
+        return finalState == PLAYER_X_MOVE || finalState == PLAYER_O_MOVE;
+    GameState expected = PLAYER_X_MOVE;
+    return finalState == announceWinner(recorded, expected);
+}
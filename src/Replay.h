@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include "Game.h"
+#include "GameRecord.h"
+
+// Plays a recorded game back through GameSession.
+// A copy of the session is kept every SnapshotInterval moves, so Seek restores the
+// nearest snapshot and replays at most SnapshotInterval - 1 moves.
+class Replay
+{
+public:
+    explicit Replay(int snapshotInterval = 8);
+
+    // false if a recorded move is illegal; the replay is then left at move 0
+    bool Load(const RecordView& record);
+
+    // position after the first `move` moves, clamped to the game
+    void Seek(int move);
+    bool Step();
+    bool AtEnd() const { return position == Length(); }
+    int Position() const { return position; }
+    int Length() const { return (int)moves.size(); }
+
+    const GameSession& Session() const { return session; }
+    CellValue RecordedResult() const { return recorded; }
+    // the replayed game ends in the recorded result, in the state announceWinner gives for it
+    bool Matches() const;
+
+private:
+    int interval;
+    int size;
+    int winLength;
+    CellValue first;
+    CellValue recorded;
+    CellValue finalResult;
+    GameState finalState;
+    std::vector<int> moves;
+    std::vector<GameSession> snapshots;
+    GameSession session;
+    int position;
+};
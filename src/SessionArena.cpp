@@ -0,0 +1,29 @@
+#include "SessionArena.h"
+
+SessionArena::SessionArena(int size, int winLength)
+    : session(size, winLength), seats{nullptr, nullptr}
+{
+    record.moves.reserve(size * size);
+    ais[0].setPiece(X);
+    ais[1].setPiece(O);
+}
+
+void SessionArena::NewGame()
+{
+    session.Reset();
+    for (AIPlayer& ai : ais)
+        ai.ClearStop();
+    seats[0] = seats[1] = nullptr;
+}
+
+void SessionArena::SeatPlayers(GameMode mode)
+{
+    seats[0] = &humans[0];
+    seats[1] = (mode == VERSUS_AI) ? static_cast<Player*>(&ais[1]) : &humans[1];
+}
+
+const GameRecord& SessionArena::Record(RecordSource source, uint64_t startMs, uint32_t durationMs)
+{
+    FillRecord(session, source, startMs, durationMs, record);
+    return record;
+}
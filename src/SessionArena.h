@@ -0,0 +1,38 @@
+#pragma once
+#include "GameRecord.h"
+#include "GameTypes.h"
+#include "Game.h"
+#include "Player.h"
+
+// Everything a game needs, allocated once when the board size is known: the session,
+// both kinds of player for each seat and the record of the finished game. Starting a new
+// game only resets state, so back to back games (the UI's play again, the headless drivers)
+// cause no allocator traffic. The AI players keep their search buffers between games.
+class SessionArena
+{
+public:
+    SessionArena(int size = 3, int winLength = 3);
+    SessionArena(const SessionArena&) = delete;
+    SessionArena& operator=(const SessionArena&) = delete;
+
+    // empty board and empty seats, the AI players keep their settings
+    void NewGame();
+    // seat 0 is always human in the UI, seat 1 is the AI against VERSUS_AI
+    void SeatPlayers(GameMode mode);
+    bool IsSeated() const { return seats[0] != nullptr && seats[1] != nullptr; }
+    Player* Seat(int seat) const { return seats[seat]; }
+
+    GameSession& Session() { return session; }
+    HumanPlayer& Human(int seat) { return humans[seat]; }
+    AIPlayer& AI(int seat) { return ais[seat]; }
+
+    // the session's current game, filled into the same buffer every time
+    const GameRecord& Record(RecordSource source, uint64_t startMs, uint32_t durationMs);
+
+private:
+    GameSession session;
+    HumanPlayer humans[2];
+    AIPlayer ais[2];
+    Player* seats[2];
+    GameRecord record;
+};
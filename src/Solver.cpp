@@ -0,0 +1,120 @@
+#include "Solver.h"
+
+Solver::Solver(int tableBits)
+    : table(size_t(1) << tableBits), tableShift(32 - tableBits)
+{
+    ClearTable();
+}
+
+void Solver::ClearTable()
+{
+    for (Entry& entry : table)
+    {
+        entry = Entry{0, 0, -1, BOUND_NONE};
+    }
+}
+
+int Solver::BestMove(const Board& board, CellValue player)
+{
+    if (board.Winner() != NO_ONE)
+        return -1;
+
+    Board scratch = board;
+    int alpha = -MaxScore;
+    int bestMove = -1;
+    for (int move : BestMoves)
+    {
+        if (!scratch.IsLegal(move))
+            continue;
+        scratch.MakeMove(move, player);
+        int score = -Negamax(scratch, Opponent(player), -MaxScore, -alpha);
+        scratch.UndoMove(move);
+        if (bestMove < 0 || score > alpha)
+        {
+            alpha = score;
+            bestMove = move;
+        }
+    }
+    return bestMove;
+}
+
+int Solver::Evaluate(const Board& board, CellValue player)
+{
+    Board scratch = board;
+    return Negamax(scratch, player, -MaxScore, MaxScore);
+}
+
+int Solver::Negamax(Board& board, CellValue player, int alpha, int beta)
+{
+    stats.nodes++;
+
+    // only the previous move can have finished the game
+    int moves = board.MoveCount();
+    if (Board::HasLine(board.Pieces(Opponent(player))))
+        return -(MaxScore - moves);
+    if (moves == Board::Cells)
+        return 0;
+
+    const int alphaOrig = alpha;
+    const int betaOrig = beta;
+    int transform;
+    const uint32_t key = Key(board, player, transform);
+    Entry& entry = Slot(key);
+    int ttMove = -1;
+    stats.ttProbes++;
+    if (entry.bound != BOUND_NONE && entry.key == key)
+    {
+        stats.ttHits++;
+        if (entry.bestMove >= 0)
+            ttMove = Symmetry::UnmapCell(transform, entry.bestMove);
+        if (entry.bound == BOUND_EXACT ||
+            (entry.bound == BOUND_LOWER && entry.score >= beta) ||
+            (entry.bound == BOUND_UPPER && entry.score <= alpha))
+        {
+            stats.ttCutoffs++;
+            return entry.score;
+        }
+    }
+
+    // a win on this move can't be beaten, the upper bound tightens the window for free
+    const int bestPossible = MaxScore - moves - 1;
+    if (beta > bestPossible)
+    {
+        beta = bestPossible;
+        if (alpha >= beta)
+            return beta;
+    }
+
+    int bestScore = -MaxScore;
+    int bestMove = -1;
+    for (int i = -1; i < Board::Cells; ++i)
+    {
+        // the table move goes first, then center, corners and edges
+        int move = (i < 0) ? ttMove : BestMoves[i];
+        if (move < 0 || (i >= 0 && move == ttMove) || !board.IsLegal(move))
+            continue;
+
+        board.MakeMove(move, player);
+        int score = -Negamax(board, Opponent(player), -beta, -alpha);
+        board.UndoMove(move);
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestMove = move;
+        }
+        if (score > alpha)
+            alpha = score;
+        if (alpha >= beta)
+            break;
+    }
+
+    Entry& slot = Slot(key);
+    slot.key = key;
+    slot.score = int8_t(bestScore);
+    slot.bestMove = int8_t(bestMove < 0 ? -1 : Symmetry::MapCell(transform, bestMove));
+    slot.bound = (bestScore <= alphaOrig) ? BOUND_UPPER : (bestScore >= betaOrig) ? BOUND_LOWER
+                                                                                  : BOUND_EXACT;
+    stats.ttStores++;
+    return bestScore;
+}
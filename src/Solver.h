@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+#include "Symmetry.h"
+
+struct SolverStats
+{
+    uint64_t nodes = 0;
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+    uint64_t ttCutoffs = 0;
+    uint64_t ttStores = 0;
+};
+
+// Perfect play for the 3x3 board: alpha-beta negamax over a hashed transposition table.
+// The table is keyed on the canonical (symmetry-reduced) position, stored moves are canonical cells.
+// Scores are from the side to move: a win scores (Cells + 1 - moves played), so faster wins
+// and slower losses score higher, a draw scores 0.
+class Solver
+{
+public:
+    static constexpr int MaxScore = Board::Cells + 1;
+    static constexpr int BestMoves[Board::Cells] = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+
+    explicit Solver(int tableBits = 12);
+
+    // best cell for player, -1 if the game is already over
+    int BestMove(const Board& board, CellValue player);
+    // exact game value for player to move
+    int Evaluate(const Board& board, CellValue player);
+
+    const SolverStats& Stats() const { return stats; }
+    void ResetStats() { stats = SolverStats(); }
+    void ClearTable();
+
+private:
+    enum Bound : uint8_t
+    {
+        BOUND_NONE,
+        BOUND_EXACT,
+        BOUND_LOWER,
+        BOUND_UPPER
+    };
+    struct Entry
+    {
+        uint32_t key;
+        int8_t score;
+        int8_t bestMove;
+        Bound bound;
+    };
+
+    static uint32_t Key(const Board& board, CellValue player, int& transform)
+    {
+        Symmetry::Canonical canonical = Symmetry::Canonicalize(board.Pieces(X), board.Pieces(O));
+        transform = canonical.transform;
+        return canonical.first | (uint32_t(canonical.second) << 9) | (uint32_t(player == O) << 18);
+    }
+    Entry& Slot(uint32_t key) { return table[(key * 0x9E3779B1u) >> tableShift]; }
+
+    int Negamax(Board& board, CellValue player, int alpha, int beta);
+
+    std::vector<Entry> table;
+    int tableShift;
+    SolverStats stats;
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstring>
+#include <random>
+#include <variant>
+#include <vector>
+#include "Game.h"
+#include "GenericBoard.h"
+#include "Heuristic.h"
+#include "Player.h"
+#include "WinTracker.h"
+
+// Move pickers for simulated games and the window's AI seat: the AI player (book and
+// solver on 3x3), computerMove from old_ver.cpp, uniform random play and the AI player's
+// MCTS and iterative deepening searches, as move providers for PlayGame and AsyncAI.
+enum StrategyKind
+{
+    STRATEGY_PERFECT,
+    STRATEGY_HEURISTIC,
+    STRATEGY_RANDOM,
+    STRATEGY_MCTS,
+    STRATEGY_DEEPENING,
+    STRATEGY_COUNT
+};
+
+inline const char* StrategyName(StrategyKind kind)
+{
+    static const char* names[STRATEGY_COUNT] = {"perfect", "heuristic", "random", "mcts", "deepening"};
+    return names[kind];
+}
+
+inline bool ParseStrategy(const char* name, StrategyKind& kind)
+{
+    for (int i = 0; i < STRATEGY_COUNT; ++i)
+    {
+        if (strcmp(name, StrategyName(StrategyKind(i))) == 0)
+        {
+            kind = StrategyKind(i);
+            return true;
+        }
+    }
+    // older spelling used by the headless driver
+    if (strcmp(name, "ai") == 0)
+    {
+        kind = STRATEGY_PERFECT;
+        return true;
+    }
+    return false;
+}
+
+inline int RandomMove(const DynamicBoard& board, std::mt19937& rng)
+{
+    int empty = board.CellCount() - board.MoveCount();
+    int pick = std::uniform_int_distribution<int>(0, empty - 1)(rng);
+    for (int cell = 0; cell < board.CellCount(); ++cell)
+    {
+        if (board.IsLegal(cell) && pick-- == 0)
+            return cell;
+    }
+    return -1;
+}
+
+// Move providers for the template game loops below. Each is a small handle with
+// int NextMove(const DynamicBoard&, const WinTracker&), -1 when it has no move.
+struct HumanMoves
+{
+    HumanPlayer* human;
+    int NextMove(const DynamicBoard& board, const WinTracker& tracker) { return human->NextMove(board, tracker); }
+};
+
+// the script's moves from the start of the game, for both sides, then -1
+struct ScriptedMoves
+{
+    const std::vector<int>* script;
+    int NextMove(const DynamicBoard& board, const WinTracker&) const
+    {
+        size_t ply = size_t(board.MoveCount());
+        return (ply < script->size()) ? (*script)[ply] : -1;
+    }
+};
+
+struct HeuristicMoves
+{
+    CellValue piece;
+    int NextMove(const DynamicBoard& board, const WinTracker& tracker) const
+    {
+        return WithGeometry(board.GetGeometry(), [&](auto geometry) {
+            return HeuristicMove(GenericBoard<decltype(geometry)>(board, geometry), tracker, piece);
+        });
+    }
+};
+
+struct RandomMoves
+{
+    std::mt19937* rng;
+    int NextMove(const DynamicBoard& board, const WinTracker&) { return RandomMove(board, *rng); }
+};
+
+// book and solver, MCTS or iterative deepening, whichever strategy the AI player is set to
+struct SearchMoves
+{
+    AIPlayer* ai;
+    int NextMove(const DynamicBoard& board, const WinTracker& tracker) { return ai->AIMove(board, tracker); }
+};
+
+// first's moves while it has any, then second's
+template <typename First, typename Second>
+struct ThenMoves
+{
+    First first;
+    Second second;
+    int NextMove(const DynamicBoard& board, const WinTracker& tracker)
+    {
+        int cell = first.NextMove(board, tracker);
+        return (cell >= 0) ? cell : second.NextMove(board, tracker);
+    }
+};
+
+// a provider picked at run time; std::visit turns it back into the concrete type
+using MoveProvider = std::variant<HumanMoves, ScriptedMoves, HeuristicMoves, RandomMoves, SearchMoves>;
+
+// ai must already have its piece set
+inline MoveProvider MakeProvider(StrategyKind kind, AIPlayer& ai, std::mt19937& rng)
+{
+    switch (kind)
+    {
+        case STRATEGY_PERFECT: ai.SetStrategy(AI_AUTO); return SearchMoves{&ai};
+        case STRATEGY_MCTS: ai.SetStrategy(AI_MCTS); return SearchMoves{&ai};
+        case STRATEGY_DEEPENING: ai.SetStrategy(AI_DEEPENING); return SearchMoves{&ai};
+        case STRATEGY_HEURISTIC: return HeuristicMoves{ai.getPiece()};
+        default: return RandomMoves{&rng};
+    }
+}
+
+// Plays the session's game to the end; onMove(piece, cell) sees every move before it is played.
+// Instantiated per provider pair, so the calls in the loop are direct and can be inlined.
+// False if a provider came up with an illegal move, the game is left unfinished then.
+template <typename XMoves, typename OMoves, typename OnMove>
+bool PlayGame(GameSession& session, XMoves& x, OMoves& o, OnMove&& onMove)
+{
+    while (session.IsPlaying())
+    {
+        CellValue piece = session.ToMove();
+        int cell = (piece == X) ? x.NextMove(session.GetBoard(), session.GetTracker())
+                                : o.NextMove(session.GetBoard(), session.GetTracker());
+        onMove(piece, cell);
+        if (!session.PlayMove(cell))
+            return false;
+    }
+    return true;
+}
+
+template <typename XMoves, typename OMoves>
+bool PlayGame(GameSession& session, XMoves& x, OMoves& o)
+{
+    return PlayGame(session, x, o, [](CellValue, int) {});
+}
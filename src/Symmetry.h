@@ -0,0 +1,103 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Board.h"
+
+// The eight rotations and reflections of the 3x3 square (the D4 group).
+// A board is canonical when its (X, O) masks are the smallest over all eight transforms.
+// Moves found on a canonical board are mapped back through the inverse transform.
+class Symmetry
+{
+public:
+    static constexpr int Count = 8;
+    static constexpr int Identity = 0;
+
+    struct Canonical
+    {
+        uint16_t first;
+        uint16_t second;
+        int transform;  // takes the original board to the canonical one
+    };
+
+    static uint16_t Apply(int transform, uint16_t mask) { return MaskTable[transform][mask]; }
+    static int MapCell(int transform, int cell) { return CellTable[transform][cell]; }
+    static int UnmapCell(int transform, int cell) { return CellTable[Inverse[transform]][cell]; }
+
+    static Canonical Canonicalize(uint16_t first, uint16_t second)
+    {
+        Canonical best{first, second, Identity};
+        uint32_t bestKey = first | (uint32_t(second) << 9);
+        for (int t = 1; t < Count; ++t)
+        {
+            uint16_t a = MaskTable[t][first];
+            uint16_t b = MaskTable[t][second];
+            uint32_t key = a | (uint32_t(b) << 9);
+            if (key < bestKey)
+            {
+                bestKey = key;
+                best = Canonical{a, b, t};
+            }
+        }
+        return best;
+    }
+
+    static Board Canonicalize(const Board& board, int& transform)
+    {
+        Canonical c = Canonicalize(board.Pieces(X), board.Pieces(O));
+        transform = c.transform;
+        return Board::FromMasks(c.first, c.second);
+    }
+
+    // (row, col) images for each transform, row-major cells
+    static constexpr int Map(int transform, int cell)
+    {
+        int r = cell / 3, c = cell % 3;
+        switch (transform)
+        {
+            case 1: return c * 3 + (2 - r);  // rotate 90
+            case 2: return (2 - r) * 3 + (2 - c);  // rotate 180
+            case 3: return (2 - c) * 3 + r;  // rotate 270
+            case 4: return r * 3 + (2 - c);  // mirror left-right
+            case 5: return (2 - r) * 3 + c;  // mirror top-bottom
+            case 6: return c * 3 + r;  // main diagonal
+            case 7: return (2 - c) * 3 + (2 - r);  // anti-diagonal
+            default: return cell;
+        }
+    }
+
+private:
+    static constexpr int Inverse[Count] = {0, 3, 2, 1, 4, 5, 6, 7};
+    static const std::array<std::array<int8_t, Board::Cells>, Count> CellTable;
+    static const std::array<std::array<uint16_t, Board::FullMask + 1>, Count> MaskTable;
+};
+
+constexpr std::array<std::array<int8_t, Board::Cells>, Symmetry::Count> BuildCellTable()
+{
+    std::array<std::array<int8_t, Board::Cells>, Symmetry::Count> table = {};
+    for (int t = 0; t < Symmetry::Count; ++t)
+        for (int cell = 0; cell < Board::Cells; ++cell)
+            table[t][cell] = int8_t(Symmetry::Map(t, cell));
+    return table;
+}
+
+constexpr std::array<std::array<uint16_t, Board::FullMask + 1>, Symmetry::Count> BuildMaskTable()
+{
+    std::array<std::array<uint16_t, Board::FullMask + 1>, Symmetry::Count> table = {};
+    for (int t = 0; t < Symmetry::Count; ++t)
+    {
+        for (unsigned mask = 0; mask <= Board::FullMask; ++mask)
+        {
+            uint16_t image = 0;
+            for (int cell = 0; cell < Board::Cells; ++cell)
+            {
+                if ((mask >> cell) & 1)
+                    image |= uint16_t(1u << Symmetry::Map(t, cell));
+            }
+            table[t][mask] = image;
+        }
+    }
+    return table;
+}
+
+inline constexpr std::array<std::array<int8_t, Board::Cells>, Symmetry::Count> Symmetry::CellTable = BuildCellTable();
+inline constexpr std::array<std::array<uint16_t, Board::FullMask + 1>, Symmetry::Count> Symmetry::MaskTable = BuildMaskTable();
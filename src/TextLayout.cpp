@@ -0,0 +1,57 @@
+#include "TextLayout.h"
+
+int TextLayout::AddCentered(const char* text, int fontSize, int y)
+{
+    return Add(Item{text, fontSize, ANCHOR_CANVAS, Rectangle{0.0f, (float)y, 0.0f, 0.0f}, 0, 0, 0, 0});
+}
+
+int TextLayout::AddInRect(const char* text, int fontSize, Rectangle rec, int padding)
+{
+    return Add(Item{text, fontSize, ANCHOR_RECT, rec, padding, 0, 0, 0});
+}
+
+int TextLayout::Add(const Item& item)
+{
+    items.push_back(item);
+    dirty = true;
+    return (int)items.size() - 1;
+}
+
+void TextLayout::SetText(int id, const char* text)
+{
+    items[id].text = text;
+    dirty = true;
+}
+
+bool TextLayout::Update(int canvasWidth, int canvasHeight)
+{
+    if (!dirty && canvasWidth == width && canvasHeight == height)
+        return false;
+    width = canvasWidth;
+    height = canvasHeight;
+    for (Item& item : items)
+        Layout(item);
+    dirty = false;
+    return true;
+}
+
+void TextLayout::Layout(Item& item) const
+{
+    item.width = MeasureText(item.text, item.fontSize);
+    if (item.anchor == ANCHOR_CANVAS)
+    {
+        item.x = (width - item.width) / 2;
+        item.y = (int)item.rec.y;
+    }
+    else
+    {
+        item.x = (int)(item.rec.x + item.rec.width / 2 - item.width / 2);
+        item.y = (int)item.rec.y + item.padding;
+    }
+}
+
+void TextLayout::Draw(int id, Color color) const
+{
+    const Item& item = items[id];
+    DrawText(item.text, item.x, item.y, item.fontSize, color);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <raylib-cpp.hpp>
+
+// Positions of the UI strings in canvas coordinates, measured once and reused every frame.
+// Everything is laid out again only when the canvas size changes or after Invalidate
+// (a string was replaced, e.g. on a language change).
+class TextLayout
+{
+public:
+    // centered horizontally on the canvas, top edge at y
+    int AddCentered(const char* text, int fontSize, int y);
+    // centered horizontally in a button, padding pixels below its top edge
+    int AddInRect(const char* text, int fontSize, Rectangle rec, int padding = 5);
+
+    void SetText(int id, const char* text);
+    void Invalidate() { dirty = true; }
+    // call once per frame before drawing; cheap when nothing changed, true after a new
+    // layout so text already drawn at the old positions can be redrawn
+    bool Update(int canvasWidth, int canvasHeight);
+
+    void Draw(int id, Color color) const;
+    int Width(int id) const { return items[id].width; }
+
+private:
+    enum Anchor
+    {
+        ANCHOR_CANVAS,
+        ANCHOR_RECT
+    };
+    struct Item
+    {
+        const char* text;
+        int fontSize;
+        Anchor anchor;
+        Rectangle rec;  // ANCHOR_RECT: the button, ANCHOR_CANVAS: y only
+        int padding;
+        // computed by Layout
+        int x, y, width;
+    };
+
+    int Add(const Item& item);
+    void Layout(Item& item) const;
+
+    std::vector<Item> items;
+    int width = 0;
+    int height = 0;
+    bool dirty = true;
+};
@@ -0,0 +1,94 @@
+#include "TranspositionTable.h"
+#include <climits>
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+    : mask(0), generation(0)
+{
+    Resize(megabytes);
+}
+
+void TranspositionTable::Resize(size_t megabytes)
+{
+    size_t count = (megabytes << 20) / BucketBytes;
+    size_t power = 1;
+    while (power * 2 <= count)
+        power *= 2;
+    buckets.reset(new Bucket[power]);
+    mask = power - 1;
+    Clear();
+}
+
+void TranspositionTable::Clear()
+{
+    for (uint64_t i = 0; i <= mask; ++i)
+    {
+        for (Entry& entry : buckets[i].entries)
+        {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+bool TranspositionTable::Probe(uint64_t key, TTData& out, TTCounters& counters) const
+{
+    counters.probes++;
+    const Bucket& bucket = buckets[key & mask];
+    int used = 0;
+    for (const Entry& entry : bucket.entries)
+    {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if (data == 0)
+            continue;
+        used++;
+        if ((check ^ data) != key)
+            continue;
+        out.score = int32_t(uint32_t(data));
+        out.move = int((data >> 32) & 0xFFFF) - 1;
+        out.depth = Depth(data);
+        out.bound = TTBound((data >> 56) & 3);
+        counters.hits++;
+        return true;
+    }
+    if (used == BucketEntries)
+        counters.collisions++;
+    return false;
+}
+
+void TranspositionTable::Store(uint64_t key, int score, int move, int depth, TTBound bound, TTCounters& counters)
+{
+    Bucket& bucket = buckets[key & mask];
+    Entry* target = nullptr;
+    int targetValue = INT_MAX;
+    bool samePosition = false;
+    for (Entry& entry : bucket.entries)
+    {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if (data != 0 && (check ^ data) == key)
+        {
+            // a deeper result for this position from the current search is worth more than a bound
+            if (Generation(data) == generation && Depth(data) > depth && bound != TT_EXACT)
+                return;
+            if (move < 0)
+                move = int((data >> 32) & 0xFFFF) - 1;
+            target = &entry;
+            samePosition = true;
+            break;
+        }
+        int value = (data == 0) ? INT_MIN : Depth(data) - 8 * ((generation - Generation(data)) & GenerationMask);
+        if (value < targetValue)
+        {
+            target = &entry;
+            targetValue = value;
+        }
+    }
+    counters.stores++;
+    if (!samePosition && targetValue != INT_MIN)
+        counters.overwrites++;
+    uint64_t data = Pack(score, move, depth, bound, generation);
+    target->data.store(data, std::memory_order_relaxed);
+    target->check.store(key ^ data, std::memory_order_relaxed);
+}
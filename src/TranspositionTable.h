@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+enum TTBound : uint8_t
+{
+    TT_NONE,
+    TT_EXACT,
+    TT_LOWER,
+    TT_UPPER
+};
+
+struct TTData
+{
+    int score;
+    int move;  // -1 if the entry has none
+    int depth;
+    TTBound bound;
+};
+
+// Kept by each searching thread and summed afterwards, so counting doesn't make the
+// threads fight over a shared cache line.
+struct TTCounters
+{
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t collisions = 0;  // misses in a bucket full of other positions
+    uint64_t stores = 0;
+    uint64_t overwrites = 0;  // stores that evicted another position
+
+    void Add(const TTCounters& other)
+    {
+        probes += other.probes;
+        hits += other.hits;
+        collisions += other.collisions;
+        stores += other.stores;
+        overwrites += other.overwrites;
+    }
+};
+
+// Fixed-size hash table of search results shared by all search threads without locks.
+// An entry is two 64-bit words, the packed data and key ^ data, stored with relaxed atomics.
+// A reader checks that the two words still XOR to its key, so an entry torn by two racing
+// writers reads as a miss instead of as another position's result.
+// Four entries make a 64-byte bucket, one cache line, and a key only ever looks at its bucket.
+// A store replaces the same position, else an empty entry, else the shallowest one, entries
+// from older searches (see NewSearch) counting as shallower the older they are.
+class TranspositionTable
+{
+public:
+    static const int BucketEntries = 4;
+    static const size_t BucketBytes = 64;
+
+    explicit TranspositionTable(size_t megabytes = 16);
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // memory budget, rounded down to a power of two of buckets (at least one); clears the table
+    void Resize(size_t megabytes);
+    size_t Bytes() const { return size_t(mask + 1) * BucketBytes; }
+    // not safe while a search is running
+    void Clear();
+    // once per move, before the threads start
+    void NewSearch() { generation = uint8_t((generation + 1) & GenerationMask); }
+
+    bool Probe(uint64_t key, TTData& out, TTCounters& counters) const;
+    void Store(uint64_t key, int score, int move, int depth, TTBound bound, TTCounters& counters);
+
+private:
+    static const uint8_t GenerationMask = 63;
+
+    struct Entry
+    {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;  // 0 when empty
+    };
+    struct alignas(64) Bucket
+    {
+        Entry entries[BucketEntries];
+    };
+    static_assert(sizeof(Bucket) == BucketBytes, "a bucket is one cache line");
+
+    // score: 32 bits, move + 1: 16, depth: 8, bound: 2, generation: 6
+    static uint64_t Pack(int score, int move, int depth, TTBound bound, uint8_t generation)
+    {
+        return uint64_t(uint32_t(score)) | (uint64_t(uint16_t(move + 1)) << 32) | (uint64_t(uint8_t(depth)) << 48) |
+               (uint64_t(bound) << 56) | (uint64_t(generation) << 58);
+    }
+    static int Depth(uint64_t data) { return int((data >> 48) & 0xFF); }
+    static uint8_t Generation(uint64_t data) { return uint8_t(data >> 58); }
+
+    std::unique_ptr<Bucket[]> buckets;
+    uint64_t mask;
+    uint8_t generation;
+};
@@ -0,0 +1,76 @@
+#include "WinTracker.h"
+
+WinTracker::WinTracker(int size, int winLength)
+    : size(size), winLength(winLength), offsets(size * size + 1, 0)
+{
+    const int dr[4] = {0, 1, 1, 1};
+    const int dc[4] = {1, 0, 1, -1};
+
+    // every window by its first cell and direction, then bucket its cells per cell
+    std::vector<std::vector<uint16_t>> linesOfCell(size * size);
+    int lines = 0;
+    for (int d = 0; d < 4; ++d)
+    {
+        for (int row = 0; row < size; ++row)
+        {
+            for (int col = 0; col < size; ++col)
+            {
+                int lastRow = row + dr[d] * (winLength - 1);
+                int lastCol = col + dc[d] * (winLength - 1);
+                if (lastRow < 0 || lastRow >= size || lastCol < 0 || lastCol >= size)
+                    continue;
+                for (int i = 0; i < winLength; ++i)
+                    linesOfCell[(row + dr[d] * i) * size + col + dc[d] * i].push_back(uint16_t(lines));
+                lines++;
+            }
+        }
+    }
+    for (int cell = 0; cell < size * size; ++cell)
+    {
+        offsets[cell + 1] = uint16_t(offsets[cell] + linesOfCell[cell].size());
+        cellLines.insert(cellLines.end(), linesOfCell[cell].begin(), linesOfCell[cell].end());
+    }
+    counts.resize(lines);
+    Reset();
+}
+
+void WinTracker::Reset()
+{
+    for (Line& line : counts)
+        line = Line{{0, 0}};
+    moves = 0;
+    completed[0] = completed[1] = 0;
+}
+
+void WinTracker::MakeMove(int cell, CellValue player)
+{
+    const int side = player - X;
+    for (int i = offsets[cell]; i < offsets[cell + 1]; ++i)
+    {
+        if (++counts[cellLines[i]].stones[side] == winLength)
+            completed[side]++;
+    }
+    moves++;
+}
+
+void WinTracker::UndoMove(int cell, CellValue player)
+{
+    const int side = player - X;
+    for (int i = offsets[cell]; i < offsets[cell + 1]; ++i)
+    {
+        if (counts[cellLines[i]].stones[side]-- == winLength)
+            completed[side]--;
+    }
+    moves--;
+}
+
+bool WinTracker::WouldWin(int cell, CellValue player) const
+{
+    const int side = player - X;
+    for (int i = offsets[cell]; i < offsets[cell + 1]; ++i)
+    {
+        if (counts[cellLines[i]].stones[side] == winLength - 1)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "GameTypes.h"
+
+// Incremental game result for an N x N, K-in-a-row board.
+// Every K-cell window ("line") keeps a stone count per side. A move only touches the
+// lines through its cell (at most 4 * K of them), so the result after a move or an
+// undo is known in O(K) without scanning the board.
+// Lines through a cell are stored contiguously (offsets[cell] .. offsets[cell + 1]).
+class WinTracker
+{
+public:
+    WinTracker(int size = 3, int winLength = 3);
+
+    void Reset();
+    // cell must be empty; the tracker doesn't hold the board itself
+    void MakeMove(int cell, CellValue player);
+    void UndoMove(int cell, CellValue player);
+
+    // X, O, TIES or NO_ONE, same answer as Winner() on the matching board
+    CellValue Result() const
+    {
+        if (completed[0] > 0) return X;
+        if (completed[1] > 0) return O;
+        if (moves == size * size) return TIES;
+        return NO_ONE;
+    }
+    // would player complete a line by playing cell
+    bool WouldWin(int cell, CellValue player) const;
+
+    int Size() const { return size; }
+    int WinLength() const { return winLength; }
+    int LineCount() const { return int(counts.size()); }
+    int MoveCount() const { return moves; }
+
+    // the lines through cell, and a line's stone count for one side (for evaluation)
+    const uint16_t* LinesBegin(int cell) const { return cellLines.data() + offsets[cell]; }
+    const uint16_t* LinesEnd(int cell) const { return cellLines.data() + offsets[cell + 1]; }
+    int Stones(int line, CellValue player) const { return counts[line].stones[player - X]; }
+
+private:
+    struct Line
+    {
+        uint8_t stones[2];
+    };
+
+    int size;
+    int winLength;
+    int moves;
+    int completed[2];
+    std::vector<uint16_t> offsets;
+    std::vector<uint16_t> cellLines;
+    std::vector<Line> counts;
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Hands out the indices [0, count) to a fixed set of workers without locks.
+// Every worker owns a range packed into one 64-bit atomic (begin low, end high). The owner
+// claims chunks from the front of its range; a worker whose range is empty steals the back
+// half of another worker's range. Both are a single compare-and-swap. A range value never
+// repeats in a slot once work has been taken from it, so the swaps can't suffer ABA.
+class RangeScheduler
+{
+public:
+    RangeScheduler(uint32_t count, int workers, uint32_t chunk)
+        : slots(workers), chunk(chunk > 0 ? chunk : 1)
+    {
+        for (int i = 0; i < workers; ++i)
+        {
+            uint32_t begin = uint32_t(uint64_t(count) * i / workers);
+            uint32_t end = uint32_t(uint64_t(count) * (i + 1) / workers);
+            slots[i].range.store(Pack(begin, end), std::memory_order_relaxed);
+        }
+    }
+
+    // next chunk for worker, false once every range is drained
+    bool Next(int worker, uint32_t& begin, uint32_t& end)
+    {
+        std::atomic<uint64_t>& own = slots[worker].range;
+        for (;;)
+        {
+            uint64_t range = own.load(std::memory_order_acquire);
+            uint32_t b = Begin(range), e = End(range);
+            if (b < e)
+            {
+                uint32_t n = (e - b < chunk) ? e - b : chunk;
+                if (own.compare_exchange_weak(range, Pack(b + n, e), std::memory_order_acq_rel))
+                {
+                    begin = b;
+                    end = b + n;
+                    return true;
+                }
+                continue;
+            }
+            if (!Steal(worker))
+                return false;
+            steals++;
+        }
+    }
+
+    uint64_t Steals() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> range;
+    };
+
+    static uint64_t Pack(uint32_t begin, uint32_t end) { return begin | (uint64_t(end) << 32); }
+    static uint32_t Begin(uint64_t range) { return uint32_t(range); }
+    static uint32_t End(uint64_t range) { return uint32_t(range >> 32); }
+
+    // moves the back half of some victim's range into the (empty) range of thief
+    bool Steal(int thief)
+    {
+        const int workers = int(slots.size());
+        for (int i = 1; i < workers; ++i)
+        {
+            std::atomic<uint64_t>& victim = slots[(thief + i) % workers].range;
+            uint64_t range = victim.load(std::memory_order_acquire);
+            while (Begin(range) < End(range))
+            {
+                uint32_t b = Begin(range), e = End(range);
+                uint32_t mid = b + (e - b) / 2;
+                if (victim.compare_exchange_weak(range, Pack(b, mid), std::memory_order_acq_rel))
+                {
+                    slots[thief].range.store(Pack(mid, e), std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    std::vector<Slot> slots;
+    uint32_t chunk;
+    std::atomic<uint64_t> steals{0};
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "GameTypes.h"
+
+// Zobrist position keys: one 64-bit number per (side, cell), XOR-ed over the stones on the
+// board, plus one for O to move. A move changes the key with a single XOR, so boards keep
+// it up to date in MakeMove/UndoMove instead of hashing the cells again.
+// The numbers come from splitmix64 at compile time from a fixed seed: the same on every
+// build and platform, so keys written to disk or used for replays stay valid. Changing the
+// seed or the generator changes every key (see the check below).
+constexpr uint64_t ZobristSeed = 0x2545F4914F6CDD1Dull;
+constexpr int ZobristCells = 19 * 19;  // MaxBoardSize squared
+
+struct ZobristTable
+{
+    uint64_t cells[2][ZobristCells];
+    uint64_t oToMove;
+};
+
+constexpr uint64_t SplitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristTable BuildZobristTable(uint64_t seed)
+{
+    ZobristTable table = {};
+    uint64_t state = seed;
+    for (int side = 0; side < 2; ++side)
+        for (int cell = 0; cell < ZobristCells; ++cell)
+            table.cells[side][cell] = SplitMix64(state);
+    table.oToMove = SplitMix64(state);
+    return table;
+}
+
+inline constexpr ZobristTable Zobrist = BuildZobristTable(ZobristSeed);
+static_assert(Zobrist.cells[0][0] == 0xC0E16B163A85A4DCull, "Zobrist keys changed, stored keys would no longer match");
+
+inline uint64_t ZobristStone(CellValue player, int cell)
+{
+    return Zobrist.cells[player - X][cell];
+}
+
+// The keys of a board under all eight rotations and reflections of the square, kept up to
+// date move by move like the plain key. The smallest is the same for every symmetric
+// variant of a position, so tables can share one entry between them. Transforms are
+// numbered as in Symmetry.h. Kept apart from the boards so only callers that want
+// symmetry pay the eight XORs per move.
+class SymmetricKeys
+{
+public:
+    static constexpr int Count = 8;
+
+    explicit SymmetricKeys(int size = 3) : size(size)
+    {
+        for (int t = 0; t < Count; ++t)
+        {
+            images[t].resize(size * size);
+            for (int cell = 0; cell < size * size; ++cell)
+                images[t][cell] = uint16_t(Map(t, cell));
+        }
+        Reset();
+    }
+
+    void Reset() { keys.fill(0); }
+    // a stone placed or removed
+    void Toggle(int cell, CellValue player)
+    {
+        for (int t = 0; t < Count; ++t)
+            keys[t] ^= Zobrist.cells[player - X][images[t][cell]];
+    }
+
+    uint64_t Key(int transform) const { return keys[transform]; }
+    // the smallest of the eight keys, with the side to move folded in; transform is the one that gave it
+    uint64_t Canonical(CellValue toMove, int& transform) const
+    {
+        transform = 0;
+        for (int t = 1; t < Count; ++t)
+        {
+            if (keys[t] < keys[transform])
+                transform = t;
+        }
+        return keys[transform] ^ ((toMove == O) ? Zobrist.oToMove : 0);
+    }
+    // where cell goes under transform
+    int Map(int transform, int cell) const
+    {
+        const int n = size - 1;
+        int r = cell / size, c = cell % size;
+        switch (transform)
+        {
+            case 1: return c * size + (n - r);  // rotate 90
+            case 2: return (n - r) * size + (n - c);  // rotate 180
+            case 3: return (n - c) * size + r;  // rotate 270
+            case 4: return r * size + (n - c);  // mirror left-right
+            case 5: return (n - r) * size + c;  // mirror top-bottom
+            case 6: return c * size + r;  // main diagonal
+            case 7: return (n - c) * size + (n - r);  // anti-diagonal
+            default: return cell;
+        }
+    }
+
+private:
+    int size;
+    std::array<uint64_t, Count> keys;
+    std::vector<uint16_t> images[Count];
+};
@@ -4,122 +4,192 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
 #include <raylib-cpp.hpp>
+#include "GameTypes.h"
+#include "Game.h"
+#include "GameRecord.h"
+#include "Player.h"
+#include "SessionArena.h"
+#include "Strategy.h"
+#include "AsyncAI.h"
+#include "Log.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "DirtyTracker.h"
+#include "CellAtlas.h"
+#include "TextLayout.h"
+#include "InputMap.h"
 
 // global variables
-const int COLS = 3;
-const int ROWS = 3;
-const int NumSquares = 9;
-const int cellWidth = 200;
-const int cellHeight = 200;
+const int gridSize = 600;
 const int screenWidth = 1280;
 const int screenHeight = 800;
-int MoveNumber = 0;
+const char* BookPath = "resources/tictactoe.book";
+// every finished game is appended here, rotated to games.ttr.1 past RecordLimit
+const char* RecordPath = "games.ttr";
+const uint64_t RecordLimit = 64ull << 20;
+// replay playback speed, seconds per move
+const double ReplayStepTime = 0.5;
+// the thinking message only shows for moves that take longer than this, in seconds
+const double ThinkingMessageDelay = 0.1;
+// how long the menu error and the game result stay on screen, in seconds
+const double ErrorMessageTime = 1.0;
+const double ResultTime = 2.0;
 
 // UI text
 static const char* MainMenuMessage[] = {
     "Please select a game mode and choose who moves first.",
-    "Then press the Start button.",
+    "Pick the AI strategy below for Versus AI, then press Start.",
     "Please first select a game mode and who moves first"};
 static const char* MainMenuButtons[] = {"Hotseat", "Versus AI", "X moves first", "O moves first", "Start Game"};
+// the row under the menu, by StrategyKind
+static const char* StrategyButtons[] = {"Perfect", "Heuristic", "Random", "MCTS", "Deepening"};
+static_assert(sizeof(StrategyButtons) / sizeof(StrategyButtons[0]) == STRATEGY_COUNT, "a strategy without a button");
 static const char* GameLoopMessages[] = {"Player X move", "Player O move"};
 static const char* WinText[] = {"PLAYER X WIN!", "PLAYER O WIN!", "IT'S A TIE!", "THE GAME IS FINISHED. PLAY AGAIN?"};
 static const char* YesNoText[] = {"YES", "NO"};
+static const char* ThinkingText = "AI is thinking...";
 // UI text
 
-enum CellValue
-{
-    EMPTY,
-    X,
-    O,
-    TIES,
-    NO_ONE
-};
-enum GameMode
-{
-    HOTSEAT,
-    VERSUS_AI
-};
-enum GameState
-{
-    MAINMENU,
-    PLAYER_X_MOVE,
-    PLAYER_O_MOVE,
-    PLAYER_X_WIN,
-    PLAYER_O_WIN,
-    TIE,
-    GAME_FINISHED
-};
-
-struct Cell
-{
-    int cellNumber;
-    int indexI;
-    int indexJ;
-    CellValue value;
-    Color cellColor;
-
-    Cell(int cellNumber = 0, int indexI = 0, int indexJ = 0, CellValue value = EMPTY, Color cellColor = GRAY)
-        : cellNumber(cellNumber), indexI(indexI), indexJ(indexJ), value(value), cellColor(cellColor) {}
-};
-
 class Grid
 {
 public:
-    Grid();
+    Grid(int size = 3);
     void GridInit();
-    void DrawGrid();
-    bool ChangeCellState(Vector2 MousePosition, CellValue player, std::vector<CellValue>& board);
-    void ChangeCellColor(GameState& currentGameState);
-    bool IsMoveLegal(Vector2 MousePosition);
+    // redraws only the cells that changed since the last call, see Invalidate
+    void DrawGrid(const DynamicBoard& board);
+    void Invalidate();
+    bool ChangeCellState(int cellNum, CellValue player, GameSession& session);
+    void ChangeCellColor(GameState currentGameState);
+    bool IsMoveLegal(int cellNum, const DynamicBoard& board);
+    // where the cells are on screen, for the input mapper
+    CellMapping Mapping() const;
 
 private:
-    std::vector<std::vector<Cell>> grid;
+    int size;
+    int cellWidth;
+    int cellHeight;
+    // the winner's cells are drawn with the win color
+    CellValue highlight;
+    DirtyTracker drawnCells;
+    CellAtlas atlas;
 };
 
-class Player
+int main(int argc, char** argv)
 {
-    CellValue piece;
-
-public:
-    virtual ~Player() {}
-    virtual void HumanMove(Grid& grid, std::vector<CellValue>& board);
-    void setPiece(CellValue p) { piece = p; };
-    CellValue getPiece() const { return piece; };
-};
-
-class HumanPlayer : public Player
-{
-public:
-    void HumanMove(Grid& grid, std::vector<CellValue>& board) override;
-};
-
-class AIPlayer : public Player
-{
-public:
-    void AIMove();
-};
-
-CellValue checkWinner(std::vector<CellValue>& board);
-
-GameState announceWinner(CellValue winner, GameState& currentGameState);
+    // board setup: --size N --win K, classic 3x3 by default
+    // --profile records phase timings (F3 shows them), --trace FILE also sets where they are written
+    // --replay FILE [--game N] plays a recorded game back (space pauses, left/right step)
+    // --ai perfect|heuristic|random|mcts|deepening preselects the AI strategy of the main menu,
+    // mcts and deepening search for one second per move
+    int boardSize = 3;
+    int winLength = 3;
+    bool profile = false;
+    const char* tracePath = "profile_trace.json";
+    const char* replayPath = nullptr;
+    int replayGame = 0;
+    StrategyKind aiKind = STRATEGY_PERFECT;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            boardSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--win") == 0 && i + 1 < argc)
+            winLength = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--profile") == 0)
+            profile = true;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+            profile = true;
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--game") == 0 && i + 1 < argc)
+            replayGame = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ai") == 0 && i + 1 < argc)
+        {
+            if (!ParseStrategy(argv[++i], aiKind))
+                WARN_LOG("Unknown AI strategy %s", argv[i]);
+        }
+    }
 
-bool IsMouseOnGrid(Vector2 MousePosition);
+    // the replayed game decides the board
+    Replay replay;
+    bool replaying = false;
+    if (replayPath != nullptr)
+    {
+        GameRecordReader reader;
+        RecordView view;
+        bool found = reader.Open(replayPath);
+        for (int i = 0; found && i <= replayGame; i++)
+            found = reader.Next(view);
+        if (found && replay.Load(view))
+        {
+            replaying = true;
+            boardSize = view.size;
+            winLength = view.winLength;
+        }
+        else
+            WARN_LOG("Cannot replay game %d from %s", replayGame, replayPath);
+    }
+    if (boardSize < 3 || boardSize > MaxBoardSize)
+        boardSize = 3;
+    if (winLength < 3 || winLength > boardSize)
+        winLength = (boardSize < 5) ? boardSize : 5;
+    // board setup
 
-int main()
-{
     // Window init
     raylib::Window window(screenWidth, screenHeight, "TicTacToe");
     window.SetTargetFPS(60);
     // Window init
 
     // creating game objects
-    GameState currentGameState = MAINMENU;
-    GameMode currentGameMode;
-    std::unique_ptr<Player> player1;
-    std::unique_ptr<Player> player2;
-    Grid grid;
-    std::vector<CellValue> board(NumSquares, EMPTY);
+    GameMode currentGameMode = HOTSEAT;
+    // the session and both players live here for the whole run, play again only resets them
+    SessionArena arena(boardSize, winLength);
+    GameSession& session = arena.Session();
+    // declared after the arena so it stops before the players are destroyed
+    AsyncAI aiWorker;
+    Grid grid(boardSize);
+    bool replayPaused = false;
+    double nextReplayStep = 0.0;
+    if (replaying)
+        session = replay.Session();
+    OpeningBook openingBook;
+    if (!openingBook.Load(BookPath))
+    {
+        // no book on disk (see "make book"), solve it once now
+        Solver solver;
+        openingBook.Generate(solver);
+    }
+    // the AI seat plays whatever provider the menu's strategy turns into at game start
+    AIPlayer& ai = arena.AI(1);
+    ai.SetBook(&openingBook);
+    std::mt19937 aiRng(std::random_device{}());
+    MoveProvider aiMoves = SearchMoves{&ai};
+    MctsConfig mcts;
+    mcts.timeMs = 1000.0;
+    mcts.threads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    ai.SetMctsConfig(mcts);
+    DeepeningConfig deepening;
+    deepening.timeMs = 1000.0;
+    deepening.threads = mcts.threads;
+    deepening.tableMegabytes = 64;
+    ai.SetDeepeningConfig(deepening);
+
+    GameRecordWriter recordWriter;
+    if (!recordWriter.Open(RecordPath, RecordLimit))
+        WARN_LOG("Game records disabled, cannot write %s", RecordPath);
+    uint64_t gameStartMs = 0;
+    bool gameRecorded = false;
+
+    FrameProfiler profiler;
+    profiler.SetEnabled(profile);
+    bool drawProfiler = profile;
 
     // creating game objects
 
@@ -133,13 +203,20 @@ int main()
     bool drawErrorMessage = false;
     bool exitGame = false;
 
-    int MessageCounter = 0;
+    double errorMessageUntil = 0.0;
+    double finishAt = 0.0;
 
-    Rectangle MainMenuRecs[5] = {0};
+    // the five menu buttons, then one per strategy in a row below them
+    const int MainMenuCount = 5 + STRATEGY_COUNT;
+    Rectangle MainMenuRecs[MainMenuCount] = {0};
     for (int i = 0; i < 5; i++)
     {
         MainMenuRecs[i] = (Rectangle){(screenWidth / 2) - 75.0f, (float)(250 + 32 * i), 150.0f, 30.0f};
     }
+    for (int i = 0; i < STRATEGY_COUNT; i++)
+    {
+        MainMenuRecs[5 + i] = (Rectangle){(screenWidth / 2) - 76.0f * STRATEGY_COUNT + 152.0f * i, 430.0f, 150.0f, 30.0f};
+    }
     Rectangle YesNoRecs[2] = {0};
     for (int i = 0; i < 2; i++)
     {
@@ -147,19 +224,61 @@ int main()
     }
     // Main menu UI
 
+    // UI text layout, ids follow the string tables
+    TextLayout textLayout;
+    int mainMenuText[3];
+    mainMenuText[0] = textLayout.AddCentered(MainMenuMessage[0], 30, screenHeight - 750);
+    mainMenuText[1] = textLayout.AddCentered(MainMenuMessage[1], 30, screenHeight - 720);
+    mainMenuText[2] = textLayout.AddCentered(MainMenuMessage[2], 40, (screenHeight / 2) - 20);
+    int mainMenuButtonText[MainMenuCount];
+    for (int i = 0; i < 5; i++)
+        mainMenuButtonText[i] = textLayout.AddInRect(MainMenuButtons[i], 20, MainMenuRecs[i]);
+    for (int i = 0; i < STRATEGY_COUNT; i++)
+        mainMenuButtonText[5 + i] = textLayout.AddInRect(StrategyButtons[i], 20, MainMenuRecs[5 + i]);
+    int gameLoopText[2];
+    for (int i = 0; i < 2; i++)
+        gameLoopText[i] = textLayout.AddCentered(GameLoopMessages[i], 40, screenHeight - 750);
+    int thinkingText = textLayout.AddCentered(ThinkingText, 30, screenHeight - 80);
+    int winText[4];
+    for (int i = 0; i < 4; i++)
+        winText[i] = textLayout.AddCentered(WinText[i], 40, screenHeight - 750);
+    int yesNoText[2];
+    for (int i = 0; i < 2; i++)
+        yesNoText[i] = textLayout.AddInRect(YesNoText[i], 20, YesNoRecs[i]);
+    // UI text layout
+
+    InputMapper inputMapper(screenWidth, screenHeight);
+    inputMapper.SetBoard(grid.Mapping());
+
+    // Retained rendering: the scene lives in a render texture and only changed cells and
+    // buttons are redrawn into it. While nothing is animating the loop blocks on input events.
+    RenderTexture2D canvas = LoadRenderTexture(screenWidth, screenHeight);
+    DirtyTracker menuButtons(MainMenuCount);
+    DirtyTracker yesNoButtons(2);
+    uint32_t drawnScene = 0xFFFFFFFFu;
+    bool waitingForEvents = false;
+    static const Color ButtonFill[] = {LIGHTGRAY, SKYBLUE, GREEN};
+
     // main game loop
     while (!exitGame)
     {
+        profiler.BeginFrame();
+        profiler.BeginPhase(PHASE_INPUT);
+        const FrameInput& input = inputMapper.Sample();
         if (window.ShouldClose() || IsKeyPressed(KEY_ESCAPE))
         {
             exitGame = true;
         }
+        if (IsKeyPressed(KEY_F3))
+        {
+            drawProfiler = !drawProfiler;
+        }
         // Menu UI update
-        if (currentGameState == MAINMENU)
+        if (session.State() == MAINMENU)
         {
-            for (int i = 0; i < 5; i++)
+            for (int i = 0; i < MainMenuCount; i++)
             {
-                if (CheckCollisionPointRec(GetMousePosition(), MainMenuRecs[i]))
+                if (CheckCollisionPointRec(input.mouse, MainMenuRecs[i]))
                 {
                     mouseHoverRec = i;
                     break;
@@ -167,7 +286,7 @@ int main()
                 else
                     mouseHoverRec = -1;
             }
-            if ((mouseHoverRec >= 0) && IsMouseButtonReleased(MOUSE_BUTTON_LEFT))
+            if ((mouseHoverRec >= 0) && input.leftReleased)
             {
                 mainMenuButtonSelected = mouseHoverRec;
                 buttonClicked = true;
@@ -178,26 +297,24 @@ int main()
                 {
                     case 0:  // Hotseat
                     {
-                        player1 = std::make_unique<HumanPlayer>();
-                        player2 = std::make_unique<HumanPlayer>();
+                        arena.SeatPlayers(HOTSEAT);
                         currentGameMode = HOTSEAT;
                         isGameModeSelected = true;
                         break;
                     }
                     case 1:  // Versus AI
                     {
-                        player1 = std::make_unique<HumanPlayer>();
-                        player2 = std::make_unique<AIPlayer>();
+                        arena.SeatPlayers(VERSUS_AI);
                         currentGameMode = VERSUS_AI;
                         isGameModeSelected = true;
                         break;
                     }
                     case 2:  // Player X moves first
                     {
-                        if (player1 != nullptr && player2 != nullptr)
+                        if (arena.IsSeated())
                         {
-                            player1->setPiece(X);
-                            player2->setPiece(O);
+                            arena.Seat(0)->setPiece(X);
+                            arena.Seat(1)->setPiece(O);
                             isFirstMoveSelected = true;
                         }
                         else
@@ -206,10 +323,10 @@ int main()
                     }
                     case 3:  // Player O moves first
                     {
-                        if (player1 != nullptr && player2 != nullptr)
+                        if (arena.IsSeated())
                         {
-                            player1->setPiece(O);
-                            player2->setPiece(X);
+                            arena.Seat(0)->setPiece(O);
+                            arena.Seat(1)->setPiece(X);
                             isFirstMoveSelected = true;
                         }
                         else
@@ -220,42 +337,42 @@ int main()
                     {
                         if ((isGameModeSelected && isFirstMoveSelected))
                         {
-                            if (player1->getPiece() == X)
-                            {
-                                currentGameState = PLAYER_X_MOVE;
-                            }
-                            else
-                            {
-                                currentGameState = PLAYER_O_MOVE;
-                            }
-                            // board.resize(NumSquares, EMPTY);
+                            // the AI's piece is known now, which the heuristic provider needs
+                            if (currentGameMode == VERSUS_AI)
+                                aiMoves = MakeProvider(aiKind, ai, aiRng);
+                            session.Start(arena.Seat(0)->getPiece());
+                            gameStartMs = RecordClockMs();
+                            gameRecorded = false;
                         }
                         else
                             drawErrorMessage = true;
                         break;
                     }
+                    default:  // AI strategy
+                        aiKind = StrategyKind(mainMenuButtonSelected - 5);
+                        break;
                 }
                 buttonClicked = false;
             }
             if (drawErrorMessage)
             {
-                MessageCounter++;
-                if (MessageCounter > 60)
+                if (errorMessageUntil == 0.0)
+                    errorMessageUntil = GetTime() + ErrorMessageTime;
+                else if (GetTime() > errorMessageUntil)
                 {
                     drawErrorMessage = false;
-                    MessageCounter = 0;
+                    errorMessageUntil = 0.0;
                 }
             }
         }
         // Menu UI update
-        // e printf("GameState: %d Move number: %d\n", currentGameState, MoveNumber);
         // Restart menu
-        if (currentGameState == GAME_FINISHED)
+        if (session.State() == GAME_FINISHED)
         {
             isGameFinished = false;
             for (int i = 0; i < 2; i++)
             {
-                if (CheckCollisionPointRec(GetMousePosition(), YesNoRecs[i]))
+                if (CheckCollisionPointRec(input.mouse, YesNoRecs[i]))
                 {
                     mouseHoverRec = i;
                     break;
@@ -263,7 +380,7 @@ int main()
                 else
                     mouseHoverRec = -1;
             }
-            if ((mouseHoverRec >= 0) && IsMouseButtonReleased(MOUSE_BUTTON_LEFT))
+            if ((mouseHoverRec >= 0) && input.leftReleased)
             {
                 mainMenuButtonSelected = mouseHoverRec;
                 buttonClicked = true;
@@ -273,370 +390,303 @@ int main()
                 switch (mainMenuButtonSelected)
                 {
                     case 0: {
-                        if (player1 != nullptr && player2 != nullptr)
-                        {
-                            player1 = nullptr;
-                            player2 = nullptr;
-                            printf("Players destoyed\n");
-                        }
-                        board.assign(NumSquares, EMPTY);
+                        aiWorker.Cancel();
+                        arena.NewGame();
+                        DEBUG_LOG("New game");
                         grid.GridInit();
                         isGameModeSelected = false;
                         isFirstMoveSelected = false;
                         drawErrorMessage = false;
-                        currentGameState = MAINMENU;
+                        errorMessageUntil = 0.0;
                         mainMenuButtonSelected = -1;
-                        MoveNumber = 0;
                         break;
                     }
 
                     case 1:
+                        aiWorker.Cancel();
                         exitGame = true;
                         break;
                 }
             }
         }
+        profiler.EndPhase(PHASE_INPUT);
+        profiler.BeginPhase(PHASE_UPDATE);
         if (isGameFinished)
         {
-            MessageCounter++;
-            if (MessageCounter > 120)
+            if (finishAt == 0.0)
+                finishAt = GetTime() + ResultTime;
+            else if (GetTime() > finishAt)
             {
-                currentGameState = GAME_FINISHED;
-                MessageCounter = 0;
+                session.Finish();
+                finishAt = 0.0;
                 isGameFinished = false;
             }
         }
         // Restart menu
-        if (currentGameMode == HOTSEAT && (currentGameState == PLAYER_X_MOVE || currentGameState == PLAYER_O_MOVE))
+        if (replaying)
         {
-            if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && IsMouseOnGrid(GetMousePosition()))
+            int target = replay.Position();
+            if (IsKeyPressed(KEY_SPACE))
+                replayPaused = !replayPaused;
+            if (IsKeyPressed(KEY_RIGHT))
+                target++;
+            if (IsKeyPressed(KEY_LEFT))
+                target--;
+            if (!replayPaused && !replay.AtEnd() && GetTime() >= nextReplayStep)
             {
-                if (currentGameState == PLAYER_X_MOVE)
-                {
-                    if (player1->getPiece() == X && grid.IsMoveLegal(GetMousePosition()))
-                    {
-                        grid.ChangeCellState(GetMousePosition(), X, board);
-                        currentGameState = announceWinner(checkWinner(board), currentGameState);
-                    }
-                    else if (player2->getPiece() == X && grid.IsMoveLegal(GetMousePosition()))
-                    {
-                        grid.ChangeCellState(GetMousePosition(), X, board);
-                        currentGameState = announceWinner(checkWinner(board), currentGameState);
-                    }
-                }
-                else if (currentGameState == PLAYER_O_MOVE)
+                target = replay.Position() + 1;
+                nextReplayStep = GetTime() + ReplayStepTime;
+            }
+            if (target != replay.Position())
+            {
+                replay.Seek(target);
+                session = replay.Session();
+                grid.ChangeCellColor(session.State());
+            }
+        }
+        else if (session.IsPlaying())
+        {
+            // the session knows whose turn it is, the players decide how the move is chosen
+            CellValue piece = session.ToMove();
+            if (currentGameMode == VERSUS_AI && arena.Seat(1)->getPiece() == piece)
+            {
+                // the move is computed on the worker thread, the frame only checks on it
+                profiler.BeginPhase(PHASE_AI);
+                if (!aiWorker.IsThinking())
+                    aiWorker.Start(aiMoves, session.GetBoard(), session.GetTracker());
+                int move = -1;
+                bool ready = aiWorker.Poll(move);
+                profiler.EndPhase(PHASE_AI);
+                if (ready && move >= 0)
                 {
-                    if (player1->getPiece() == O && grid.IsMoveLegal(GetMousePosition()))
-                    {
-                        grid.ChangeCellState(GetMousePosition(), O, board);
-                        currentGameState = announceWinner(checkWinner(board), currentGameState);
-                    }
-                    else if (player2->getPiece() == O && grid.IsMoveLegal(GetMousePosition()))
-                    {
-                        grid.ChangeCellState(GetMousePosition(), O, board);
-                        currentGameState = announceWinner(checkWinner(board), currentGameState);
-                    }
+                    session.PlayMove(move);
                 }
             }
+            else
+            {
+                // the human seat holding the piece takes the click
+                HumanPlayer& human = arena.Human((arena.Seat(0)->getPiece() == piece) ? 0 : 1);
+                if (input.leftPressed && grid.IsMoveLegal(input.cell, session.GetBoard()))
+                    human.Submit(input.cell);
+                int move = human.NextMove(session.GetBoard(), session.GetTracker());
+                if (move >= 0)
+                    grid.ChangeCellState(move, piece, session);
+            }
         }
-        else if (currentGameState == PLAYER_X_WIN || currentGameState == PLAYER_O_WIN || currentGameState == TIE)
+        else if (session.IsDecided())
         {
+            if (!gameRecorded)
+            {
+                RecordSource source = (currentGameMode == VERSUS_AI) ? RECORD_VERSUS_AI : RECORD_HOTSEAT;
+                recordWriter.Write(arena.Record(source, gameStartMs, uint32_t(RecordClockMs() - gameStartMs)));
+                // games are rare in the UI, so write through instead of waiting for the buffer to fill
+                recordWriter.Flush();
+                gameRecorded = true;
+            }
             isGameFinished = true;
-            grid.ChangeCellColor(currentGameState);
+            grid.ChangeCellColor(session.State());
         }
+        profiler.EndPhase(PHASE_UPDATE);
         // Player interaction section
         //  Drawing section
-        window.BeginDrawing();
-        window.ClearBackground(RAYWHITE);
-        switch (currentGameState)
+        profiler.BeginPhase(PHASE_DRAW);
+        // the header text and layout only change with the state or the error message
+        bool showThinking = aiWorker.ThinkingSeconds() > ThinkingMessageDelay;
+        uint32_t scene = (uint32_t)session.State() | (drawErrorMessage ? 0x100u : 0u) | (showThinking ? 0x200u : 0u);
+        // text is drawn into the canvas, which the window only scales; a new layout needs a full redraw
+        bool relayout = textLayout.Update(screenWidth, screenHeight);
+        bool fullRedraw = relayout || scene != drawnScene;
+        BeginTextureMode(canvas);
+        if (fullRedraw)
+        {
+            drawnScene = scene;
+            ClearBackground(RAYWHITE);
+            menuButtons.Invalidate();
+            yesNoButtons.Invalidate();
+            grid.Invalidate();
+            switch (session.State())
+            {
+                case 0:
+                    textLayout.Draw(mainMenuText[0], GRAY);
+                    textLayout.Draw(mainMenuText[1], GRAY);
+                    if (drawErrorMessage)
+                    {
+                        textLayout.Draw(mainMenuText[2], RED);
+                    }
+                    break;
+                case 1:
+                case 2:
+                    textLayout.Draw(gameLoopText[session.State() - 1], BLUE);
+                    if (showThinking)
+                        textLayout.Draw(thinkingText, GRAY);
+                    break;
+                case 3:
+                case 4:
+                case 5:
+                case 6:
+                    textLayout.Draw(winText[session.State() - 3], BLUE);
+                    break;
+            }
+        }
+        switch (session.State())
         {
             case 0: {
-                DrawText(MainMenuMessage[0], (screenWidth - MeasureText(MainMenuMessage[0], 30)) / 2, screenHeight - 750, 30, GRAY);
-                DrawText(MainMenuMessage[1], (screenWidth - MeasureText(MainMenuMessage[1], 30)) / 2, screenHeight - 720, 30, GRAY);
-
                 if (drawErrorMessage)
+                    break;
+                // fill: 0 idle, 1 hovered or chosen, 2 ready to start
+                bool chosen[MainMenuCount] = {isGameModeSelected && currentGameMode == HOTSEAT,
+                                              isGameModeSelected && currentGameMode == VERSUS_AI,
+                                              arena.IsSeated() && isFirstMoveSelected && arena.Seat(0)->getPiece() == X,
+                                              arena.IsSeated() && isFirstMoveSelected && arena.Seat(0)->getPiece() == O,
+                                              isGameModeSelected && isFirstMoveSelected};
+                for (int i = 0; i < STRATEGY_COUNT; i++)
+                    chosen[5 + i] = aiKind == i;
+                for (int i = 0; i < MainMenuCount; i++)
                 {
-                    DrawText(MainMenuMessage[2], (screenWidth - MeasureText(MainMenuMessage[2], 40)) / 2, (screenHeight / 2) - 20, 40, RED);
-                }
-                else
-                {  // Draw rectangles
-                    if (isGameModeSelected && currentGameMode == HOTSEAT)
-                    {
-                        DrawRectangleRec(MainMenuRecs[0], SKYBLUE);
-                    }
-                    else
-                    {
-                        DrawRectangleRec(MainMenuRecs[0], ((0 == mouseHoverRec)) ? SKYBLUE : LIGHTGRAY);
-                    }
-                    if (isGameModeSelected && currentGameMode == VERSUS_AI)
-                    {
-                        DrawRectangleRec(MainMenuRecs[1], SKYBLUE);
-                    }
-                    else
-                    {
-                        DrawRectangleRec(MainMenuRecs[1], ((1 == mouseHoverRec)) ? SKYBLUE : LIGHTGRAY);
-                    }
-                    if (player1 != nullptr && (isFirstMoveSelected && player1->getPiece() == X))
-                    {
-                        DrawRectangleRec(MainMenuRecs[2], SKYBLUE);
-                    }
-                    else
-                    {
-                        DrawRectangleRec(MainMenuRecs[2], ((2 == mouseHoverRec)) ? SKYBLUE : LIGHTGRAY);
-                    }
-                    if (player1 != nullptr && (isFirstMoveSelected && player1->getPiece() == O))
-                    {
-                        DrawRectangleRec(MainMenuRecs[3], SKYBLUE);
-                    }
-                    else
-                    {
-                        DrawRectangleRec(MainMenuRecs[3], ((3 == mouseHoverRec)) ? SKYBLUE : LIGHTGRAY);
-                    }
-                    if (isGameModeSelected && isFirstMoveSelected)
-                    {
-                        DrawRectangleRec(MainMenuRecs[4], GREEN);
-                    }
-                    else
-                    {
-                        DrawRectangleRec(MainMenuRecs[4], ((4 == mouseHoverRec)) ? SKYBLUE : LIGHTGRAY);
-                    }
-                    for (int i = 0; i < 5; i++)
-                    {
-                        DrawRectangleLines((int)MainMenuRecs[i].x, (int)MainMenuRecs[i].y, (int)MainMenuRecs[i].width, (int)MainMenuRecs[i].height, ((i == mouseHoverRec)) ? BLUE : GRAY);
-                        DrawText(MainMenuButtons[i], (int)(MainMenuRecs[i].x + MainMenuRecs[i].width / 2 - MeasureText(MainMenuButtons[i], 20) / 2), (int)MainMenuRecs[i].y + 5, 20, ((i == mouseHoverRec)) ? DARKBLUE : DARKGRAY);
-                    }
+                    bool hover = (i == mouseHoverRec);
+                    int fill = chosen[i] ? ((i == 4) ? 2 : 1) : (hover ? 1 : 0);
+                    if (!menuButtons.Update(i, (uint32_t)fill | (hover ? 4u : 0u)))
+                        continue;
+                    DrawRectangleRec(MainMenuRecs[i], ButtonFill[fill]);
+                    DrawRectangleLines((int)MainMenuRecs[i].x, (int)MainMenuRecs[i].y, (int)MainMenuRecs[i].width, (int)MainMenuRecs[i].height, hover ? BLUE : GRAY);
+                    textLayout.Draw(mainMenuButtonText[i], hover ? DARKBLUE : DARKGRAY);
                 }
                 break;
             }
             case 1:
-                DrawText(TextFormat(GameLoopMessages[0]), (screenWidth - MeasureText(GameLoopMessages[0], 40)) / 2, screenHeight - 750, 40, BLUE);
-                grid.DrawGrid();
-                break;
             case 2:
-                DrawText(TextFormat(GameLoopMessages[1]), (screenWidth - MeasureText(GameLoopMessages[1], 40)) / 2, screenHeight - 750, 40, BLUE);
-                grid.DrawGrid();
-                break;
             case 3:
-                DrawText(TextFormat(WinText[0]), (screenWidth - MeasureText(WinText[0], 40)) / 2, screenHeight - 750, 40, BLUE);
-                grid.DrawGrid();
-                break;
             case 4:
-                DrawText(TextFormat(WinText[1]), (screenWidth - MeasureText(WinText[1], 40)) / 2, screenHeight - 750, 40, BLUE);
-                grid.DrawGrid();
-                break;
             case 5:
-                DrawText(TextFormat(WinText[2]), (screenWidth - MeasureText(WinText[2], 40)) / 2, screenHeight - 750, 40, BLUE);
-                grid.DrawGrid();
+                grid.DrawGrid(session.GetBoard());
                 break;
             case 6:
-                DrawText(TextFormat(WinText[3]), (screenWidth - MeasureText(WinText[3], 40)) / 2, screenHeight - 750, 40, BLUE);
                 for (int i = 0; i < 2; i++)
                 {
-                    DrawRectangleRec(YesNoRecs[i], ((i == mouseHoverRec)) ? SKYBLUE : LIGHTGRAY);
-                    DrawRectangleLines((int)YesNoRecs[i].x, (int)YesNoRecs[i].y, (int)YesNoRecs[i].width, (int)YesNoRecs[i].height, ((i == mouseHoverRec)) ? BLUE : GRAY);
-                    DrawText(YesNoText[i], (int)(YesNoRecs[i].x + YesNoRecs[i].width / 2 - MeasureText(YesNoText[i], 20) / 2), (int)YesNoRecs[i].y + 5, 20, ((i == mouseHoverRec)) ? DARKBLUE : DARKGRAY);
+                    bool hover = (i == mouseHoverRec);
+                    if (!yesNoButtons.Update(i, hover ? 1u : 0u))
+                        continue;
+                    DrawRectangleRec(YesNoRecs[i], hover ? SKYBLUE : LIGHTGRAY);
+                    DrawRectangleLines((int)YesNoRecs[i].x, (int)YesNoRecs[i].y, (int)YesNoRecs[i].width, (int)YesNoRecs[i].height, hover ? BLUE : GRAY);
+                    textLayout.Draw(yesNoText[i], hover ? DARKBLUE : DARKGRAY);
                 }
                 break;
         }
+        EndTextureMode();
+
+        window.BeginDrawing();
+        // render textures are stored bottom-up, hence the negative height; stretched to the window like the input mapping
+        DrawTexturePro(canvas.texture, (Rectangle){0.0f, 0.0f, (float)screenWidth, -(float)screenHeight},
+                       (Rectangle){0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight()}, (Vector2){0.0f, 0.0f}, 0.0f, WHITE);
+        if (drawProfiler)
+        {
+            profiler.DrawOverlay(10, 10);
+        }
+        profiler.EndPhase(PHASE_DRAW);
+        // with event waiting on, EndDrawing blocks until the next input: idle time, the frame ends before it
+        if (waitingForEvents)
+            profiler.EndFrame();
+        profiler.BeginPhase(PHASE_PRESENT);
         window.EndDrawing();
+        profiler.EndPhase(PHASE_PRESENT);
+        profiler.EndFrame();
+
+        // timers, a pending AI move and the live profiler overlay need frames without input
+        bool aiToMove = session.IsPlaying() && currentGameMode == VERSUS_AI && arena.Seat(1)->getPiece() == session.ToMove();
+        bool replayRunning = replaying && !replayPaused && !replay.AtEnd();
+        bool animating = drawErrorMessage || isGameFinished || (session.IsDecided() && !replaying) || aiToMove || drawProfiler || replayRunning;
+        if (animating == waitingForEvents)
+        {
+            waitingForEvents = !animating;
+            if (waitingForEvents)
+                EnableEventWaiting();
+            else
+                DisableEventWaiting();
+        }
+    }
+    aiWorker.Cancel();
+    UnloadRenderTexture(canvas);
+    if (profiler.IsEnabled() && profiler.WriteChromeTrace(tracePath))
+    {
+        INFO_LOG("Profile trace written to %s", tracePath);
     }
     return 0;
 }
 
-Grid::Grid()
+Grid::Grid(int size)
+    : size(size), cellWidth(gridSize / size), cellHeight(gridSize / size), drawnCells(size * size)
 {
-    grid.resize(COLS, std::vector<Cell>(ROWS));
+    atlas.Load(cellWidth);
     GridInit();
 }
 
 void Grid::GridInit()
 {
-    grid.assign(COLS, std::vector<Cell>(ROWS));
-    int cellNumber = 0;
-    for (int i = 0; i < COLS; i++)
-    {
-        for (int j = 0; j < ROWS; j++)
-        {
-            grid[i][j] = Cell(cellNumber, i, j, EMPTY, LIGHTGRAY);
-            cellNumber++;
-        }
-    }
+    highlight = EMPTY;
+    Invalidate();
 }
 
-void Grid::DrawGrid()
+void Grid::Invalidate()
 {
-    for (int i = 0; i < COLS; ++i)
-    {
-        for (int j = 0; j < ROWS; ++j)
-        {
-            int x = ((screenWidth / 2) - 300) + i * cellWidth;
-            int y = ((screenHeight / 2) - 300) + j * cellHeight;
-
-            DrawRectangle(x, y, cellWidth, cellHeight, grid[i][j].cellColor);
-            DrawRectangleLines(x, y, cellWidth, cellHeight, RAYWHITE);
-
-            // Drawing cell contents based on their value
-            if (grid[i][j].value == X)
-            {
-                DrawLine(x, y, x + cellWidth, y + cellHeight, RED);
-                DrawLine(x, y + cellHeight, x + cellWidth, y, RED);
-            }
-            else if (grid[i][j].value == O)
-            {
-                DrawCircleLines(x + cellWidth / 2, y + cellHeight / 2, cellWidth / 2 - 10, BLUE);
-            }
-        }
-    }
+    drawnCells.Invalidate();
 }
 
-bool Grid::ChangeCellState(Vector2 MousePosition, CellValue player, std::vector<CellValue>& board)
+void Grid::DrawGrid(const DynamicBoard& board)
 {
-    int i = (MousePosition.x - ((screenWidth / 2) - 300)) / cellWidth;
-    int j = (MousePosition.y - ((screenHeight / 2) - 300)) / cellHeight;
-    int cellNum = grid[i][j].cellNumber;
-    // check index for valid
-    if (i >= 0 && i < COLS && j >= 0 && j < ROWS)
+    for (int i = 0; i < size; ++i)
     {
-        // change cell state
-
-        if (grid[i][j].value == EMPTY && player == X)
+        for (int j = 0; j < size; ++j)
         {
-            grid[i][j].value = X;
-            board[cellNum] = X;
-            printf("Board: %d", board[cellNum]);
-            MoveNumber++;
-            return true;
+            int x = ((screenWidth / 2) - gridSize / 2) + i * cellWidth;
+            int y = ((screenHeight / 2) - gridSize / 2) + j * cellHeight;
+            int cellNum = j * size + i;
+            CellValue value = board.At(cellNum);
+            bool highlighted = highlight != EMPTY && value == highlight;
+            if (!drawnCells.Update(cellNum, (uint32_t)value | (highlighted ? 0x10u : 0u)))
+                continue;
+
+            CellAtlas::Sprite sprite = (value == X) ? CellAtlas::SPRITE_X : (value == O) ? CellAtlas::SPRITE_O
+                                                                                         : CellAtlas::SPRITE_EMPTY;
+            if (highlighted)
+                sprite = (value == X) ? CellAtlas::SPRITE_X_WIN : CellAtlas::SPRITE_O_WIN;
+            atlas.Draw(sprite, x, y);
         }
-        else if (grid[i][j].value == EMPTY && player == O)
-        {
-            grid[i][j].value = O;
-            board[cellNum] = O;
-            printf("Board: %d", board[cellNum]);
-            MoveNumber++;
-            return true;
-        }
-        printf("Cell num: %d\n", cellNum);
     }
-    return false;
 }
 
-void Grid::ChangeCellColor(GameState& currentGameState)
+bool Grid::ChangeCellState(int cellNum, CellValue player, GameSession& session)
 {
-    CellValue winner = (currentGameState == PLAYER_X_WIN) ? X : (currentGameState == PLAYER_O_WIN) ? O
-                                                                                                   : EMPTY;
-
-    if (winner != EMPTY)
-    {
-        for (int i = 0; i < COLS; i++)
-        {
-            for (int j = 0; j < ROWS; j++)
-            {
-                if (grid[i][j].value == winner)
-                {
-                    grid[i][j].cellColor = GREEN;
-                }
-            }
-        }
-    }
-}
-
-bool Grid::IsMoveLegal(Vector2 MousePosition)
-{
-    int i = (MousePosition.x - ((screenWidth / 2) - 300)) / cellWidth;
-    int j = (MousePosition.y - ((screenHeight / 2) - 300)) / cellHeight;
     // check index for valid
-    if (i >= 0 && i < COLS && j >= 0 && j < ROWS)
+    if (cellNum >= 0 && cellNum < size * size)
     {
-        if (grid[i][j].value == EMPTY)
+        // change cell state
+        if (player == session.ToMove() && session.PlayMove(cellNum))
         {
+            DEBUG_LOG("Board: %d", session.GetBoard().At(cellNum));
             return true;
         }
+        DEBUG_LOG("Cell num: %d", cellNum);
     }
     return false;
 }
 
-CellValue checkWinner(std::vector<CellValue>& board)
-{
-    // all possible win rows
-    const int WINNING_ROWS[8][3] = {
-        {0, 1, 2},
-        {3, 4, 5},
-        {6, 7, 8},
-        {0, 3, 6},
-        {1, 4, 7},
-        {2, 5, 8},
-        {0, 4, 8},
-        {2, 4, 6}};
-
-    // if in one of the winning rows already had all 3 signs (!= EMPTY) when the winner are announce
-    if (MoveNumber >= 5)
-    {
-        for (int i = 0; i < 8; ++i)
-        {
-            if ((board[WINNING_ROWS[i][0]] != EMPTY) &&
-                (board[WINNING_ROWS[i][0]] == board[WINNING_ROWS[i][1]]) &&
-                (board[WINNING_ROWS[i][1]] == board[WINNING_ROWS[i][2]]))
-            {
-                printf("Cell: %d\n", WINNING_ROWS[i][0]);
-                return CellValue(board[WINNING_ROWS[i][0]]);
-            }
-        }
-        if (std::count(board.begin(), board.end(), EMPTY) == 0)
-            return TIES;
-    }
-    printf("CheckWinner\n");
-    return NO_ONE;
-}
-
-GameState announceWinner(CellValue winner, GameState& currentGameState)
-{
-
-    if (winner == X)
-    {
-        currentGameState = PLAYER_X_WIN;
-        return currentGameState;
-    }
-    else if (winner == O)
-    {
-        currentGameState = PLAYER_O_WIN;
-        return currentGameState;
-    }
-    else if (winner == TIES)
-    {
-        currentGameState = TIE;
-        return currentGameState;
-    }
-    else if (winner == NO_ONE)
-    {
-        currentGameState = (currentGameState == PLAYER_O_MOVE) ? PLAYER_X_MOVE : PLAYER_O_MOVE;
-        return currentGameState;
-    }
-    else
-        return currentGameState;
-}
-
-bool IsMouseOnGrid(Vector2 MousePosition)
-{
-    // check if mouse in Cells area
-    if (MousePosition.x >= (screenWidth / 2) - 300 && MousePosition.x <= (screenWidth / 2) + 300 &&
-        MousePosition.y >= (screenHeight / 2) - 300 && MousePosition.y <= (screenHeight / 2) + 300)
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-}
-
-void AIPlayer::AIMove()
+void Grid::ChangeCellColor(GameState currentGameState)
 {
+    highlight = (currentGameState == PLAYER_X_WIN) ? X : (currentGameState == PLAYER_O_WIN) ? O
+                                                                                            : EMPTY;
 }
 
-void HumanPlayer::HumanMove(Grid& grid, std::vector<CellValue>& board)
+bool Grid::IsMoveLegal(int cellNum, const DynamicBoard& board)
 {
+    return cellNum >= 0 && cellNum < size * size && board.IsLegal(cellNum);
 }
 
-void Player::HumanMove(Grid& grid, std::vector<CellValue>& board)
+CellMapping Grid::Mapping() const
 {
+    CellMapping mapping;
+    mapping.originX = (float)((screenWidth / 2) - gridSize / 2);
+    mapping.originY = (float)((screenHeight / 2) - gridSize / 2);
+    mapping.cellSize = (float)cellWidth;
+    mapping.size = size;
+    return mapping;
 }
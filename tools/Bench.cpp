@@ -0,0 +1,497 @@
+// Micro-benchmarks for the game kernels on fixed, reproducible position sets.
+// usage: bench [--filter text] [--repetitions N] [--min-time seconds] [--json file]
+// The table goes to stderr, --json writes the same numbers for tracking between commits.
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <vector>
+#include "BenchHarness.h"
+#include "../src/BatchWinner.h"
+#include "../src/Board.h"
+#include "../src/Game.h"
+#include "../src/GenericBoard.h"
+#include "../src/Heuristic.h"
+#include "../src/OpeningBook.h"
+#include "../src/Player.h"
+#include "../src/Solver.h"
+#include "../src/WinTracker.h"
+#include "../src/Zobrist.h"
+
+std::atomic<uint64_t> bench::allocations{0};
+std::atomic<uint64_t> bench::allocatedBytes{0};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    bench::allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+namespace
+{
+using Large = DynamicBoard;
+const int LargeSize = 15;
+const int LargeWin = 5;
+
+struct ClassicPosition
+{
+    Board board;
+    CellValue toMove;
+};
+
+struct LargePosition
+{
+    Large board;
+    CellValue toMove;
+    std::vector<int> moves;
+};
+
+// every position reachable from the empty board, X first, in DFS order
+void CollectClassic(Board& board, CellValue player, std::vector<ClassicPosition>& out, std::vector<uint8_t>& seen)
+{
+    uint32_t key = board.Pieces(X) | (uint32_t(board.Pieces(O)) << 9);
+    if (seen[key])
+        return;
+    seen[key] = 1;
+    out.push_back({board, player});
+    if (board.Winner() != NO_ONE)
+        return;
+    for (int cell = 0; cell < Board::Cells; ++cell)
+    {
+        if (!board.IsLegal(cell))
+            continue;
+        board.MakeMove(cell, player);
+        CollectClassic(board, Opponent(player), out, seen);
+        board.UndoMove(cell);
+    }
+}
+
+// random games of random length that are still in progress
+std::vector<LargePosition> CollectLarge(int count, uint64_t seed)
+{
+    bench::SplitMix64 rng(seed);
+    std::vector<LargePosition> out;
+    while (int(out.size()) < count)
+    {
+        LargePosition position{Large(DynamicGeometry(LargeSize, LargeWin)), X, {}};
+        int length = 1 + rng.Below(80);
+        for (int i = 0; i < length; ++i)
+        {
+            int cell;
+            do
+                cell = rng.Below(LargeSize * LargeSize);
+            while (!position.board.IsLegal(cell));
+            position.board.MakeMove(cell, position.toMove);
+            if (position.board.Winner() != NO_ONE)
+            {
+                position.board.UndoMove(cell);
+                break;
+            }
+            position.moves.push_back(cell);
+            position.toMove = Opponent(position.toMove);
+        }
+        out.push_back(position);
+    }
+    return out;
+}
+
+WinTracker TrackerFor(const LargePosition& position)
+{
+    WinTracker tracker(LargeSize, LargeWin);
+    for (int cell : position.moves)
+        tracker.MakeMove(cell, position.board.At(cell));
+    return tracker;
+}
+
+int FirstLegal(const Large& board, int from)
+{
+    for (int i = 0; i < board.CellCount(); ++i)
+    {
+        int cell = (from + i) % board.CellCount();
+        if (board.IsLegal(cell))
+            return cell;
+    }
+    return -1;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    int repetitions = 10;
+    double minTime = 0.02;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--filter") == 0)
+            filter = argv[i + 1];
+        else if (strcmp(argv[i], "--repetitions") == 0)
+            repetitions = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--min-time") == 0)
+            minTime = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--json") == 0)
+            jsonPath = argv[i + 1];
+    }
+
+    // fixed position sets
+    std::vector<ClassicPosition> classic;
+    {
+        std::vector<uint8_t> seen(1 << 18, 0);
+        Board empty;
+        CollectClassic(empty, X, classic, seen);
+    }
+    std::vector<ClassicPosition> classicOpen;
+    for (const ClassicPosition& position : classic)
+    {
+        if (position.board.Winner() == NO_ONE)
+            classicOpen.push_back(position);
+    }
+    std::vector<WinTracker> classicTrackers;
+    for (const ClassicPosition& position : classic)
+    {
+        WinTracker tracker(3, 3);
+        for (int cell = 0; cell < Board::Cells; ++cell)
+        {
+            if (position.board.At(cell) != EMPTY)
+                tracker.MakeMove(cell, position.board.At(cell));
+        }
+        classicTrackers.push_back(tracker);
+    }
+    // the same boards as a structure of arrays for the batch win check, which has to agree with checkWinner
+    std::vector<uint16_t> classicX, classicO;
+    for (const ClassicPosition& position : classic)
+    {
+        classicX.push_back(position.board.Pieces(X));
+        classicO.push_back(position.board.Pieces(O));
+    }
+    std::vector<uint8_t> batchResults(classic.size());
+    BatchWinners(classicX.data(), classicO.data(), batchResults.data(), classic.size());
+    for (size_t i = 0; i < classic.size(); ++i)
+    {
+        if (batchResults[i] != checkWinner(classicTrackers[i]))
+        {
+            fprintf(stderr, "bench: %s batch win check disagrees with checkWinner on position %zu\n", BatchWinnersPath(), i);
+            return 1;
+        }
+    }
+    std::vector<LargePosition> large = CollectLarge(1024, 15);
+    std::vector<WinTracker> largeTrackers;
+    std::vector<FixedBoard<LargeSize, LargeWin>> largeFixed;
+    // incremental keys against keys built from scratch, and one canonical key for all eight symmetric variants
+    std::vector<SymmetricKeys> largeSymmetric;
+    for (size_t i = 0; i < large.size(); ++i)
+    {
+        const LargePosition& position = large[i];
+        SymmetricKeys symmetric(LargeSize);
+        uint64_t scratch = 0;
+        for (int cell : position.moves)
+        {
+            symmetric.Toggle(cell, position.board.At(cell));
+            scratch ^= ZobristStone(position.board.At(cell), cell);
+        }
+        if (scratch != position.board.StoneKey())
+        {
+            fprintf(stderr, "bench: incremental key differs from the scratch key on position %zu\n", i);
+            return 1;
+        }
+        int transform;
+        uint64_t canonical = symmetric.Canonical(position.toMove, transform);
+        for (int t = 0; t < SymmetricKeys::Count; ++t)
+        {
+            SymmetricKeys image(LargeSize);
+            for (int cell : position.moves)
+                image.Toggle(symmetric.Map(t, cell), position.board.At(cell));
+            int imageTransform;
+            if (image.Canonical(position.toMove, imageTransform) != canonical)
+            {
+                fprintf(stderr, "bench: canonical key differs for transform %d on position %zu\n", t, i);
+                return 1;
+            }
+        }
+        largeSymmetric.push_back(symmetric);
+    }
+    for (const LargePosition& position : large)
+    {
+        largeTrackers.push_back(TrackerFor(position));
+        FixedBoard<LargeSize, LargeWin> fixed;
+        for (int cell : position.moves)
+            fixed.MakeMove(cell, position.board.At(cell));
+        largeFixed.push_back(fixed);
+    }
+
+    OpeningBook book;
+    Solver bookSolver;
+    book.Generate(bookSolver);
+
+    std::vector<Large> classicDynamic;
+    std::vector<WinTracker> classicOpenTrackers;
+    for (const ClassicPosition& position : classicOpen)
+    {
+        Large board(DynamicGeometry(3, 3));
+        WinTracker tracker(3, 3);
+        for (int cell = 0; cell < Board::Cells; ++cell)
+        {
+            if (position.board.At(cell) != EMPTY)
+            {
+                board.MakeMove(cell, position.board.At(cell));
+                tracker.MakeMove(cell, position.board.At(cell));
+            }
+        }
+        classicDynamic.push_back(board);
+        classicOpenTrackers.push_back(tracker);
+    }
+
+    // long-lived objects are built here so their allocations stay out of the timings
+    AIPlayer players[2];
+    players[0].setPiece(X);
+    players[1].setPiece(O);
+    players[0].SetBook(&book);
+    players[1].SetBook(&book);
+    Solver solver;
+    GameSession classicSession(3, 3);
+    GameSession largeSession(LargeSize, LargeWin);
+
+    bench::Runner runner(repetitions, minTime);
+
+    // win checks
+    runner.Add("winner/board3", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            bench::DoNotOptimize(classic[i].board.Winner());
+            if (++i == classic.size()) i = 0;
+        }
+    });
+    // per board, like the single-board cases
+    runner.Add("winner/batch3", [&](uint64_t n) {
+        for (uint64_t k = 0; k < n; k += classic.size())
+        {
+            BatchWinners(classicX.data(), classicO.data(), batchResults.data(), size_t(std::min<uint64_t>(n - k, classic.size())));
+            bench::ClobberMemory();
+        }
+    });
+    runner.Add("winner/batch3-scalar", [&](uint64_t n) {
+        for (uint64_t k = 0; k < n; k += classic.size())
+        {
+            BatchWinnersScalar(classicX.data(), classicO.data(), batchResults.data(), size_t(std::min<uint64_t>(n - k, classic.size())));
+            bench::ClobberMemory();
+        }
+    });
+    runner.Add("winner/fixed15", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            bench::DoNotOptimize(largeFixed[i].Winner());
+            if (++i == largeFixed.size()) i = 0;
+        }
+    });
+    runner.Add("winner/dynamic15", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            bench::DoNotOptimize(large[i].board.Winner());
+            if (++i == large.size()) i = 0;
+        }
+    });
+    runner.Add("winner/tracker15", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            bench::DoNotOptimize(largeTrackers[i].Result());
+            if (++i == largeTrackers.size()) i = 0;
+        }
+    });
+    runner.Add("checkWinner/classic", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            bench::DoNotOptimize(checkWinner(classicTrackers[i]));
+            if (++i == classicTrackers.size()) i = 0;
+        }
+    });
+
+    // move legality
+    runner.Add("legal/board3", [&](uint64_t n) {
+        size_t i = 0;
+        int cell = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            bench::DoNotOptimize(classic[i].board.IsLegal(cell));
+            if (++cell == Board::Cells)
+            {
+                cell = 0;
+                if (++i == classic.size()) i = 0;
+            }
+        }
+    });
+    runner.Add("legal/dynamic15", [&](uint64_t n) {
+        size_t i = 0;
+        int cell = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            bench::DoNotOptimize(large[i].board.IsLegal(cell));
+            if (++cell == LargeSize * LargeSize)
+            {
+                cell = 0;
+                if (++i == large.size()) i = 0;
+            }
+        }
+    });
+
+    // move application: make and undo on one position
+    runner.Add("move/board3", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            ClassicPosition& position = classicOpen[i];
+            int cell = __builtin_ctz(position.board.EmptyCells());
+            position.board.MakeMove(cell, position.toMove);
+            bench::DoNotOptimize(position.board);
+            position.board.UndoMove(cell);
+            if (++i == classicOpen.size()) i = 0;
+        }
+    });
+    runner.Add("move/dynamic15+tracker", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            LargePosition& position = large[i];
+            int cell = FirstLegal(position.board, int(k % (LargeSize * LargeSize)));
+            position.board.MakeMove(cell, position.toMove);
+            largeTrackers[i].MakeMove(cell, position.toMove);
+            bench::DoNotOptimize(largeTrackers[i].Result());
+            largeTrackers[i].UndoMove(cell, position.toMove);
+            position.board.UndoMove(cell);
+            if (++i == large.size()) i = 0;
+        }
+    });
+    runner.Add("key/symmetric15", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            LargePosition& position = large[i];
+            int cell = FirstLegal(position.board, int(k % (LargeSize * LargeSize)));
+            largeSymmetric[i].Toggle(cell, position.toMove);
+            int transform;
+            bench::DoNotOptimize(largeSymmetric[i].Canonical(Opponent(position.toMove), transform));
+            largeSymmetric[i].Toggle(cell, position.toMove);
+            if (++i == large.size()) i = 0;
+        }
+    });
+    runner.Add("move/session3", [&](uint64_t n) {
+        GameSession& session = classicSession;
+        session.Reset();
+        session.Start(X);
+        int next = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            while (!session.GetBoard().IsLegal(next))
+                next = (next + 1) % 9;
+            session.PlayMove(next);
+            if (!session.IsPlaying())
+            {
+                session.Reset();
+                session.Start(X);
+            }
+        }
+    });
+
+    // AI move selection
+    runner.Add("ai/aimove3", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            AIPlayer& player = players[classicOpen[i].toMove - X];
+            bench::DoNotOptimize(player.AIMove(classicDynamic[i], classicOpenTrackers[i]));
+            if (++i == classicOpen.size()) i = 0;
+        }
+    });
+    runner.Add("ai/book3-probe", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            BookEntry entry;
+            const ClassicPosition& position = classicOpen[i];
+            book.Probe(position.board, position.toMove, entry);
+            bench::DoNotOptimize(entry);
+            if (++i == classicOpen.size()) i = 0;
+        }
+    });
+    runner.Add("ai/solver3-warm", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            const ClassicPosition& position = classicOpen[i];
+            bench::DoNotOptimize(solver.BestMove(position.board, position.toMove));
+            if (++i == classicOpen.size()) i = 0;
+        }
+    });
+    runner.Add("ai/solver3-cold-empty", [&](uint64_t n) {
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            solver.ClearTable();
+            bench::DoNotOptimize(solver.BestMove(Board(), X));
+        }
+    });
+    runner.Add("ai/heuristic15", [&](uint64_t n) {
+        size_t i = 0;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            const LargePosition& position = large[i];
+            bench::DoNotOptimize(HeuristicMove(position.board, largeTrackers[i], position.toMove));
+            if (++i == large.size()) i = 0;
+        }
+    });
+
+    // whole games
+    runner.Add("game/perfect3", [&](uint64_t n) {
+        GameSession& session = classicSession;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            session.Reset();
+            session.Start(X);
+            while (session.IsPlaying())
+            {
+                AIPlayer& player = players[session.ToMove() - X];
+                session.PlayMove(player.AIMove(session.GetBoard(), session.GetTracker()));
+            }
+            bench::DoNotOptimize(session.Result());
+        }
+    });
+    runner.Add("game/random15", [&](uint64_t n) {
+        bench::SplitMix64 rng(7);
+        GameSession& session = largeSession;
+        for (uint64_t k = 0; k < n; ++k)
+        {
+            session.Reset();
+            session.Start(X);
+            while (session.IsPlaying())
+                session.PlayMove(FirstLegal(session.GetBoard(), rng.Below(LargeSize * LargeSize)));
+            bench::DoNotOptimize(session.Result());
+        }
+    });
+
+    runner.Run(filter);
+
+    if (jsonPath != nullptr)
+    {
+        char context[256];
+        snprintf(context, sizeof(context), "{\"date\": %lld, \"compiler\": \"%s\", \"classic_positions\": %zu, \"large_positions\": %zu, \"batch_path\": \"%s\"}",
+                 (long long)time(nullptr), __VERSION__, classic.size(), large.size(), BatchWinnersPath());
+        if (!runner.WriteJson(jsonPath, context))
+        {
+            fprintf(stderr, "bench: can't write %s\n", jsonPath);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+#pragma once
+// A small Google-Benchmark-style harness: calibrated iteration counts, repeated runs,
+// median/mean/stddev per op, allocation counts and JSON output.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+// counted by the operator new replacement in the benchmark binary
+extern std::atomic<uint64_t> allocations;
+extern std::atomic<uint64_t> allocatedBytes;
+
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+// deterministic on every platform, unlike the distributions in <random>
+struct SplitMix64
+{
+    uint64_t state;
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+    uint64_t Next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    int Below(int n) { return int(Next() % uint64_t(n)); }
+};
+
+struct Result
+{
+    std::string name;
+    uint64_t iterations;  // per repetition
+    int repetitions;
+    double median;
+    double mean;
+    double stddev;
+    double min;
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+class Runner
+{
+public:
+    // body runs the kernel `iterations` times
+    using Body = std::function<void(uint64_t iterations)>;
+
+    Runner(int repetitions = 10, double minSeconds = 0.02) : repetitions(repetitions), minSeconds(minSeconds) {}
+
+    void Add(const std::string& name, Body body) { cases.push_back({name, body}); }
+
+    void Run(const std::string& filter)
+    {
+        fprintf(stderr, "%-34s %14s %12s %10s %8s %10s\n", "benchmark", "iterations", "ns/op", "stddev", "cv%", "allocs/op");
+        for (const Case& c : cases)
+        {
+            if (!filter.empty() && c.name.find(filter) == std::string::npos)
+                continue;
+            Result result = Measure(c);
+            fprintf(stderr, "%-34s %14llu %12.2f %10.2f %8.2f %10.3f\n", result.name.c_str(),
+                    (unsigned long long)result.iterations, result.median, result.stddev,
+                    result.mean > 0 ? 100.0 * result.stddev / result.mean : 0.0, result.allocsPerOp);
+            results.push_back(result);
+        }
+    }
+
+    bool WriteJson(const char* path, const char* context) const
+    {
+        FILE* file = fopen(path, "w");
+        if (file == nullptr)
+            return false;
+        fprintf(file, "{\n  \"context\": %s,\n  \"benchmarks\": [\n", context);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            fprintf(file,
+                    "    {\"name\": \"%s\", \"iterations\": %llu, \"repetitions\": %d, \"time_unit\": \"ns\", "
+                    "\"real_time\": %.3f, \"mean\": %.3f, \"stddev\": %.3f, \"min\": %.3f, "
+                    "\"allocs_per_op\": %.4f, \"bytes_per_op\": %.2f}%s\n",
+                    r.name.c_str(), (unsigned long long)r.iterations, r.repetitions, r.median, r.mean, r.stddev,
+                    r.min, r.allocsPerOp, r.bytesPerOp, (i + 1 < results.size()) ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+        return fclose(file) == 0;
+    }
+
+private:
+    struct Case
+    {
+        std::string name;
+        Body body;
+    };
+
+    static double Seconds(const Body& body, uint64_t iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        ClobberMemory();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Result Measure(const Case& c) const
+    {
+        // grow the iteration count until one repetition takes minSeconds
+        uint64_t iterations = 1;
+        for (;;)
+        {
+            double seconds = Seconds(c.body, iterations);
+            if (seconds >= minSeconds || iterations >= (uint64_t(1) << 40))
+                break;
+            double scale = (seconds > 0) ? std::min(10.0, 1.4 * minSeconds / seconds) : 10.0;
+            iterations = std::max(iterations + 1, uint64_t(iterations * scale));
+        }
+
+        std::vector<double> perOp;
+        uint64_t allocs = allocations.load();
+        uint64_t bytes = allocatedBytes.load();
+        for (int r = 0; r < repetitions; ++r)
+            perOp.push_back(Seconds(c.body, iterations) * 1e9 / double(iterations));
+        allocs = allocations.load() - allocs;
+        bytes = allocatedBytes.load() - bytes;
+
+        Result result;
+        result.name = c.name;
+        result.iterations = iterations;
+        result.repetitions = repetitions;
+        std::vector<double> sorted = perOp;
+        std::sort(sorted.begin(), sorted.end());
+        size_t mid = sorted.size() / 2;
+        result.median = (sorted.size() % 2) ? sorted[mid] : 0.5 * (sorted[mid - 1] + sorted[mid]);
+        result.min = sorted.front();
+        double sum = 0;
+        for (double v : perOp)
+            sum += v;
+        result.mean = sum / perOp.size();
+        double var = 0;
+        for (double v : perOp)
+            var += (v - result.mean) * (v - result.mean);
+        result.stddev = std::sqrt(var / perOp.size());
+        double ops = double(iterations) * repetitions;
+        result.allocsPerOp = allocs / ops;
+        result.bytesPerOp = bytes / ops;
+        return result;
+    }
+
+    std::vector<Case> cases;
+    std::vector<Result> results;
+    int repetitions;
+    double minSeconds;
+};
+}  // namespace bench
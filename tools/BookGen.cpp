@@ -0,0 +1,27 @@
+// Solves every reachable 3x3 position and writes the opening book.
+// usage: bookgen [output path]
+#include <chrono>
+#include <cstdio>
+#include "../src/OpeningBook.h"
+#include "../src/Solver.h"
+
+int main(int argc, char** argv)
+{
+    const char* path = (argc > 1) ? argv[1] : "resources/tictactoe.book";
+
+    Solver solver(14);
+    OpeningBook book;
+    auto start = std::chrono::steady_clock::now();
+    book.Generate(solver);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (!book.Save(path))
+    {
+        fprintf(stderr, "bookgen: can't write %s\n", path);
+        return 1;
+    }
+    const SolverStats& stats = solver.Stats();
+    printf("%d positions solved in %.2f ms (%llu nodes, %llu table hits), written to %s\n",
+           book.Size(), ms, (unsigned long long)stats.nodes, (unsigned long long)stats.ttHits, path);
+    return 0;
+}
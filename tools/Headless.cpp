@@ -0,0 +1,258 @@
+// Plays games through GameSession with no window, as fast as the CPU allows.
+// usage: headless [--games N] [--size N] [--win K] [--x perfect|heuristic|random|mcts|deepening] [--o ...]
+//                 [--first x|o] [--seed S] [--script 4,0,8,...] [--expect x|o|tie] [--record FILE]
+//                 [--mcts ITERATIONS] [--depth D] [--think-ms MS] [--threads T] [--tt-mb MB]
+// Games with the deepening strategy also print nodes, time and branching factor per search depth
+// and how the transposition table was used; --threads and --tt-mb set its threads and table size.
+// With --expect every game has to end with that result, otherwise the exit code is 1.
+//        headless --replay FILE
+// Replays every recorded game unthrottled; exit code 1 if any game no longer ends as recorded.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "../src/Game.h"
+#include "../src/GameRecord.h"
+#include "../src/OpeningBook.h"
+#include "../src/Player.h"
+#include "../src/Replay.h"
+#include "../src/SessionArena.h"
+#include "../src/Strategy.h"
+
+namespace
+{
+std::vector<int> ParseScript(const char* text)
+{
+    std::vector<int> moves;
+    for (const char* p = text; *p != '\0';)
+    {
+        moves.push_back(atoi(p));
+        p = strchr(p, ',');
+        if (p == nullptr)
+            break;
+        ++p;
+    }
+    return moves;
+}
+
+int VerifyRecords(const char* path)
+{
+    GameRecordReader reader;
+    if (!reader.Open(path))
+    {
+        fprintf(stderr, "headless: cannot read %s\n", path);
+        return 2;
+    }
+    Replay replay;
+    RecordView view;
+    uint64_t games = 0;
+    uint64_t failures = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (reader.Next(view))
+    {
+        if (!replay.Load(view) || !replay.Matches())
+        {
+            if (failures < 10)
+                fprintf(stderr, "headless: game %llu does not replay to its recorded result\n", (unsigned long long)games);
+            failures++;
+        }
+        games++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("replayed: %llu  mismatches: %llu\n", (unsigned long long)games, (unsigned long long)failures);
+    printf("time: %.3f s  games/s: %.0f\n", seconds, seconds > 0 ? games / seconds : 0.0);
+    return failures > 0 ? 1 : 0;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int games = 1000;
+    int size = 3;
+    int winLength = 3;
+    StrategyKind strategies[2] = {STRATEGY_PERFECT, STRATEGY_PERFECT};
+    CellValue first = X;
+    unsigned seed = 1;
+    std::vector<int> script;
+    CellValue expect = EMPTY;
+    const char* recordPath = nullptr;
+    // mcts plays a fixed number of iterations per move so runs are reproducible
+    MctsConfig mcts;
+    mcts.iterations = 2000;
+    mcts.timeMs = 0.0;
+    mcts.maxNodes = 1 << 18;
+    // deepening searches to a fixed depth unless --think-ms gives it a clock
+    DeepeningConfig deepening;
+    deepening.timeMs = 0.0;
+    deepening.maxDepth = 4;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const char* value = argv[i + 1];
+        if (strcmp(argv[i], "--games") == 0)
+            games = atoi(value);
+        else if (strcmp(argv[i], "--size") == 0)
+            size = atoi(value);
+        else if (strcmp(argv[i], "--win") == 0)
+            winLength = atoi(value);
+        else if (strcmp(argv[i], "--x") == 0 || strcmp(argv[i], "--o") == 0)
+        {
+            if (!ParseStrategy(value, strategies[argv[i][2] == 'o']))
+            {
+                fprintf(stderr, "headless: unknown strategy %s\n", value);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "--first") == 0)
+            first = (value[0] == 'o') ? O : X;
+        else if (strcmp(argv[i], "--seed") == 0)
+            seed = unsigned(strtoul(value, nullptr, 10));
+        else if (strcmp(argv[i], "--script") == 0)
+            script = ParseScript(value);
+        else if (strcmp(argv[i], "--expect") == 0)
+            expect = (value[0] == 'x') ? X : (value[0] == 'o') ? O
+                                                               : TIES;
+        else if (strcmp(argv[i], "--record") == 0)
+            recordPath = value;
+        else if (strcmp(argv[i], "--mcts") == 0)
+            mcts.iterations = atoi(value);
+        else if (strcmp(argv[i], "--depth") == 0)
+            deepening.maxDepth = atoi(value);
+        else if (strcmp(argv[i], "--think-ms") == 0)
+            deepening.timeMs = atof(value);
+        else if (strcmp(argv[i], "--threads") == 0)
+            deepening.threads = atoi(value);
+        else if (strcmp(argv[i], "--tt-mb") == 0)
+            deepening.tableMegabytes = size_t(atoi(value));
+        else if (strcmp(argv[i], "--replay") == 0)
+            return VerifyRecords(value);
+    }
+    if (size < 3 || size > MaxBoardSize || winLength < 3 || winLength > size)
+    {
+        fprintf(stderr, "headless: unsupported board %dx%d, %d in a row\n", size, size, winLength);
+        return 2;
+    }
+
+    OpeningBook book;
+    if (!book.Load("resources/tictactoe.book"))
+    {
+        Solver solver;
+        book.Generate(solver);
+    }
+    // the session, players and record buffer are reused by every game
+    SessionArena arena(size, winLength);
+    GameSession& session = arena.Session();
+    AIPlayer* players[2] = {&arena.AI(0), &arena.AI(1)};
+    mcts.seed = seed;
+    for (AIPlayer* player : players)
+    {
+        player->SetBook(&book);
+        player->SetMctsConfig(mcts);
+        player->SetDeepeningConfig(deepening);
+    }
+    // per depth over all deepening moves: moves reaching it, nodes, ms, branching
+    struct DepthTotals
+    {
+        uint64_t moves = 0;
+        uint64_t nodes = 0;
+        double ms = 0.0;
+        double branching = 0.0;
+    };
+    std::vector<DepthTotals> depthTotals;
+    TTCounters tableTotals;
+
+    GameRecordWriter records;
+    if (recordPath != nullptr && !records.Open(recordPath))
+    {
+        fprintf(stderr, "headless: cannot append records to %s\n", recordPath);
+        return 2;
+    }
+
+    std::mt19937 rng(seed);
+    int results[3] = {0, 0, 0};  // X, O, tie
+    int mismatches = 0;
+
+    // one loop instantiation per strategy pair, the script plays first for both sides
+    int failedGame = -1;
+    int failedMove = -1;
+    auto playGames = [&](auto x, auto o) {
+        ThenMoves<ScriptedMoves, decltype(x)> xMoves{{&script}, x};
+        ThenMoves<ScriptedMoves, decltype(o)> oMoves{{&script}, o};
+        auto onMove = [&](CellValue piece, int cell) {
+            failedMove = cell;
+            if (strategies[piece - X] != STRATEGY_DEEPENING || session.GetBoard().MoveCount() < (int)script.size())
+                return;
+            tableTotals.Add(players[piece - X]->GetTableStats());
+            for (const DepthStats& depth : players[piece - X]->GetDepthStats())
+            {
+                if ((int)depthTotals.size() < depth.depth)
+                    depthTotals.resize(depth.depth);
+                DepthTotals& totals = depthTotals[depth.depth - 1];
+                totals.moves++;
+                totals.nodes += depth.nodes;
+                totals.ms += depth.ms;
+                totals.branching += depth.branching;
+            }
+        };
+        for (int game = 0; game < games; ++game)
+        {
+            arena.NewGame();
+            session.Start(first);
+            if (!PlayGame(session, xMoves, oMoves, onMove))
+            {
+                failedGame = game;
+                return;
+            }
+
+            CellValue result = session.Result();
+            results[(result == X) ? 0 : (result == O) ? 1 : 2]++;
+            if (expect != EMPTY && result != expect)
+                mismatches++;
+            if (records.IsOpen())
+                records.Write(arena.Record(RECORD_HEADLESS, RecordClockMs(), 0));
+            session.Finish();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::visit(playGames, MakeProvider(strategies[0], *players[0], rng), MakeProvider(strategies[1], *players[1], rng));
+    if (failedGame >= 0)
+    {
+        fprintf(stderr, "headless: game %d, illegal move %d\n", failedGame, failedMove);
+        return 2;
+    }
+    records.Close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("games: %d  X wins: %d  O wins: %d  ties: %d\n", games, results[0], results[1], results[2]);
+    printf("time: %.3f s  games/s: %.0f\n", seconds, seconds > 0 ? games / seconds : 0.0);
+    if (!depthTotals.empty())
+    {
+        printf("depth  moves     avg nodes   avg ms  avg branching\n");
+        for (size_t d = 0; d < depthTotals.size(); ++d)
+        {
+            const DepthTotals& totals = depthTotals[d];
+            if (totals.moves == 0)
+                continue;
+            printf("%5zu  %5llu  %12.0f  %7.3f  %13.2f\n", d + 1, (unsigned long long)totals.moves,
+                   double(totals.nodes) / totals.moves, totals.ms / totals.moves, totals.branching / totals.moves);
+        }
+    }
+    if (tableTotals.probes > 0)
+    {
+        printf("tt: %zu MB  probes: %llu  hits: %.1f%%  collisions: %llu  stores: %llu  overwrites: %llu\n",
+               deepening.tableMegabytes, (unsigned long long)tableTotals.probes, 100.0 * tableTotals.hits / tableTotals.probes,
+               (unsigned long long)tableTotals.collisions, (unsigned long long)tableTotals.stores,
+               (unsigned long long)tableTotals.overwrites);
+    }
+    if (mismatches > 0)
+    {
+        printf("%d games did not end as expected\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Scans game record files written by the game and by headless --record.
+// usage: records FILE [--dump N]
+// Prints totals by result, source and board plus the scan rate; --dump lists the first N games.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
+#include "../src/GameRecord.h"
+
+namespace
+{
+const char* ResultName(CellValue result)
+{
+    return (result == X) ? "X" : (result == O) ? "O" : (result == TIES) ? "tie" : "unfinished";
+}
+
+const char* SourceName(RecordSource source)
+{
+    static const char* names[] = {"hotseat", "versus ai", "headless"};
+    return (source <= RECORD_HEADLESS) ? names[source] : "unknown";
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: records FILE [--dump N]\n");
+        return 2;
+    }
+    int dump = 0;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--dump") == 0)
+            dump = atoi(argv[i + 1]);
+    }
+
+    GameRecordReader reader;
+    if (!reader.Open(argv[1]))
+    {
+        fprintf(stderr, "records: cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    uint64_t games = 0;
+    uint64_t moves = 0;
+    uint64_t results[4] = {0, 0, 0, 0};  // X, O, tie, unfinished
+    uint64_t sources[RECORD_HEADLESS + 1] = {0, 0, 0};
+    std::map<std::pair<int, int>, uint64_t> boards;
+
+    auto start = std::chrono::steady_clock::now();
+    RecordView view;
+    while (reader.Next(view))
+    {
+        if (games < uint64_t(dump))
+        {
+            printf("%dx%d k=%d %s first=%s result=%s moves:", view.size, view.size, view.winLength, SourceName(view.source),
+                   ResultName(view.first), ResultName(view.result));
+            for (int i = 0; i < view.moveCount; ++i)
+                printf(" %d", view.Move(i));
+            printf("\n");
+        }
+        games++;
+        moves += view.moveCount;
+        results[(view.result == X) ? 0 : (view.result == O) ? 1 : (view.result == TIES) ? 2 : 3]++;
+        if (view.source <= RECORD_HEADLESS)
+            sources[view.source]++;
+        boards[{view.size, view.winLength}]++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("games: %llu  moves: %llu  X wins: %llu  O wins: %llu  ties: %llu  unfinished: %llu\n",
+           (unsigned long long)games, (unsigned long long)moves, (unsigned long long)results[0],
+           (unsigned long long)results[1], (unsigned long long)results[2], (unsigned long long)results[3]);
+    for (int i = 0; i <= RECORD_HEADLESS; ++i)
+        printf("  %-10s %llu\n", SourceName(RecordSource(i)), (unsigned long long)sources[i]);
+    for (const auto& board : boards)
+        printf("  %dx%d k=%d  %llu\n", board.first.first, board.first.first, board.first.second, (unsigned long long)board.second);
+    printf("scan: %.3f s  %.0f games/s  %.1f MB/s\n", seconds, seconds > 0 ? games / seconds : 0.0,
+           seconds > 0 ? reader.Bytes() / seconds / 1e6 : 0.0);
+    return 0;
+}
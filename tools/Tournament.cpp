@@ -0,0 +1,211 @@
+// Round-robin between AI strategies over all cores.
+// usage: tournament [--games N] [--threads T] [--size N] [--win K] [--seed S]
+//                   [--strategies perfect,heuristic,random,mcts,deepening] [--mcts ITERATIONS] [--depth D]
+// Every ordered pair plays N games (row strategy as X, moving first, column as O).
+// A game a strategy stops with an illegal move counts as failed, not as a draw; any failed
+// game is reported per pairing and makes the exit code 1.
+// Games are split across threads by RangeScheduler; each thread has its own RNG, session arena
+// and result table, merged once all threads have finished.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../src/Game.h"
+#include "../src/OpeningBook.h"
+#include "../src/SessionArena.h"
+#include "../src/Strategy.h"
+#include "../src/WorkStealing.h"
+
+namespace
+{
+struct PairResult
+{
+    uint64_t wins[4];  // X, O, tie, failed: a provider had no legal move
+};
+
+struct WorkerState
+{
+    std::vector<PairResult> results;
+    uint64_t games = 0;
+};
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    uint32_t games = 100000;
+    int threads = int(std::thread::hardware_concurrency());
+    int size = 3;
+    int winLength = 3;
+    unsigned seed = 1;
+    std::vector<StrategyKind> strategies = {STRATEGY_PERFECT, STRATEGY_HEURISTIC, STRATEGY_RANDOM};
+    // mcts plays a fixed number of iterations per move so results don't depend on load
+    MctsConfig mcts;
+    mcts.iterations = 2000;
+    mcts.timeMs = 0.0;
+    mcts.maxNodes = 1 << 18;
+    DeepeningConfig deepening;
+    deepening.timeMs = 0.0;
+    deepening.maxDepth = 4;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const char* value = argv[i + 1];
+        if (strcmp(argv[i], "--games") == 0)
+            games = uint32_t(strtoul(value, nullptr, 10));
+        else if (strcmp(argv[i], "--threads") == 0)
+            threads = atoi(value);
+        else if (strcmp(argv[i], "--size") == 0)
+            size = atoi(value);
+        else if (strcmp(argv[i], "--win") == 0)
+            winLength = atoi(value);
+        else if (strcmp(argv[i], "--seed") == 0)
+            seed = unsigned(strtoul(value, nullptr, 10));
+        else if (strcmp(argv[i], "--mcts") == 0)
+            mcts.iterations = atoi(value);
+        else if (strcmp(argv[i], "--depth") == 0)
+            deepening.maxDepth = atoi(value);
+        else if (strcmp(argv[i], "--strategies") == 0)
+        {
+            strategies.clear();
+            char names[256];
+            snprintf(names, sizeof(names), "%s", value);
+            for (char* name = strtok(names, ","); name != nullptr; name = strtok(nullptr, ","))
+            {
+                StrategyKind kind;
+                if (!ParseStrategy(name, kind))
+                {
+                    fprintf(stderr, "tournament: unknown strategy %s\n", name);
+                    return 2;
+                }
+                strategies.push_back(kind);
+            }
+        }
+    }
+    if (threads < 1)
+        threads = 1;
+    if (size < 3 || size > MaxBoardSize || winLength < 3 || winLength > size || strategies.empty())
+    {
+        fprintf(stderr, "tournament: bad arguments\n");
+        return 2;
+    }
+
+    OpeningBook book;
+    if (!book.Load("resources/tictactoe.book"))
+    {
+        Solver solver;
+        book.Generate(solver);
+    }
+
+    const int count = int(strategies.size());
+    const int pairs = count * count;
+    const uint64_t total = uint64_t(games) * pairs;
+    if (total > UINT32_MAX)
+    {
+        fprintf(stderr, "tournament: too many games\n");
+        return 2;
+    }
+    RangeScheduler scheduler(uint32_t(total), threads, 256);
+    std::vector<WorkerState> workers(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]() {
+            WorkerState& state = workers[t];
+            state.results.assign(pairs, PairResult{{0, 0, 0, 0}});
+            std::seed_seq seq{seed, unsigned(t)};
+            std::mt19937 rng(seq);
+            SessionArena arena(size, winLength);
+            GameSession& session = arena.Session();
+            AIPlayer* players[2] = {&arena.AI(0), &arena.AI(1)};
+            for (AIPlayer* player : players)
+            {
+                player->SetBook(&book);
+                MctsConfig config = mcts;
+                config.seed = seed * 2654435761u + unsigned(t);
+                player->SetMctsConfig(config);
+                player->SetDeepeningConfig(deepening);
+            }
+
+            uint32_t begin, end;
+            while (scheduler.Next(t, begin, end))
+            {
+                // a range can span pairings, each run of one pairing is played by its own instantiation
+                for (uint32_t game = begin; game < end;)
+                {
+                    const int pair = int(game / games);
+                    const uint32_t runEnd = std::min(end, uint32_t(pair + 1) * games);
+                    PairResult& pairResult = state.results[pair];
+                    auto playRun = [&](auto x, auto o) {
+                        for (uint32_t i = game; i < runEnd; ++i)
+                        {
+                            arena.NewGame();
+                            session.Start(X);
+                            if (!PlayGame(session, x, o))
+                            {
+                                pairResult.wins[3]++;
+                                continue;
+                            }
+                            CellValue result = session.Result();
+                            pairResult.wins[(result == X) ? 0 : (result == O) ? 1 : 2]++;
+                        }
+                    };
+                    std::visit(playRun, MakeProvider(strategies[pair / count], *players[0], rng),
+                               MakeProvider(strategies[pair % count], *players[1], rng));
+                    state.games += runEnd - game;
+                    game = runEnd;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : pool)
+        thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<PairResult> merged(pairs, PairResult{{0, 0, 0, 0}});
+    for (const WorkerState& state : workers)
+    {
+        for (int pair = 0; pair < pairs; ++pair)
+            for (int r = 0; r < 4; ++r)
+                merged[pair].wins[r] += state.results[pair].wins[r];
+    }
+
+    printf("\n%dx%d, %d in a row, %u games per pairing, %d threads\n", size, size, winLength, games, threads);
+    printf("rows play X and move first, cells are X wins / O wins / draws\n\n%-10s", "X \\ O");
+    for (StrategyKind kind : strategies)
+        printf("  %-26s", StrategyName(kind));
+    printf("\n");
+    for (int x = 0; x < count; ++x)
+    {
+        printf("%-10s", StrategyName(strategies[x]));
+        for (int o = 0; o < count; ++o)
+        {
+            const PairResult& result = merged[x * count + o];
+            char cell[96];
+            int length = snprintf(cell, sizeof(cell), "%llu / %llu / %llu", (unsigned long long)result.wins[0],
+                                  (unsigned long long)result.wins[1], (unsigned long long)result.wins[2]);
+            if (result.wins[3] > 0)
+                snprintf(cell + length, sizeof(cell) - length, " / %llu failed", (unsigned long long)result.wins[3]);
+            printf("  %-26s", cell);
+        }
+        printf("\n");
+    }
+    printf("\n%llu games in %.3f s, %.0f games/s, %llu steals\n", (unsigned long long)total, seconds,
+           seconds > 0 ? total / seconds : 0.0, (unsigned long long)scheduler.Steals());
+
+    bool failed = false;
+    for (int pair = 0; pair < pairs; ++pair)
+    {
+        if (merged[pair].wins[3] == 0)
+            continue;
+        fprintf(stderr, "tournament: %s vs %s: %llu games stopped on an illegal move\n", StrategyName(strategies[pair / count]),
+                StrategyName(strategies[pair % count]), (unsigned long long)merged[pair].wins[3]);
+        failed = true;
+    }
+    return failed ? 1 : 0;
+}